@@ -0,0 +1,91 @@
+#!/bin/bash
+#
+# Check of the per-event seeding (reproducibility.mac): runs the macro with
+# 1, 4 and 16 threads and compares the outputs, then replays three events
+# with a deposit in a separate job and compares their records with those of
+# the run.
+#
+# The outputs of each run are kept as <output>_threads<N>.txt, names which
+# do not collide with the thread shards <output>_t<thread ID>.txt.
+#
+# Usage, in the directory of reproducibility.mac:
+#   ./reproducibility.sh [exampleB4c executable]
+# The exit status is 0 if all outputs are identical and the run has events
+# with a deposit.
+
+exe=${1:-./exampleB4c}
+outputs="data braggcurve_data"
+# Outputs with per-event records (event ID in the first column)
+records="data"
+status=0
+
+# Records (not the header lines) with a deposit, the energy is in the
+# second column
+deposits() {
+  awk -F '[\t;]' '$1 ~ /^[0-9]+$/ && $2 > 0' "$1"
+}
+
+# Records of the listed events
+events() {
+  awk -F '[\t;]' -v ids="$2" \
+    'BEGIN { n = split(ids, list, " "); for ( i = 1; i <= n; ++i ) selected[list[i]] = 1 }
+     $1 ~ /^[0-9]+$/ && ( $1 in selected )' "$1"
+}
+
+for t in 1 4 16; do
+  if ! "$exe" -t $t -m reproducibility.mac > reproducibility_threads$t.out; then
+    echo "reproducibility: run with $t threads failed, see reproducibility_threads$t.out"
+    exit 1
+  fi
+  for output in $outputs; do
+    cp $output.txt ${output}_threads$t.txt
+  done
+done
+
+# Identical files of empty events prove nothing
+for output in $records; do
+  nofRecords=$(deposits ${output}_threads1.txt | wc -l)
+  if [ "$nofRecords" -eq 0 ]; then
+    echo "reproducibility: no record with a deposit in $output.txt"
+    exit 1
+  fi
+  echo "reproducibility: $nofRecords records with a deposit in $output.txt"
+done
+
+for output in $outputs; do
+  for t in 4 16; do
+    if cmp -s ${output}_threads1.txt ${output}_threads$t.txt; then
+      echo "reproducibility: $output.txt identical with 1 and $t threads"
+    else
+      echo "reproducibility: $output.txt differs between 1 and $t threads"
+      status=1
+    fi
+  done
+done
+
+# Replay of the first, a middle and the last event with a deposit
+ids=$(deposits data_threads1.txt \
+        | awk -F '[\t;]' '{ id[NR] = $1 }
+                          END { print id[1], id[int((NR + 1) / 2)], id[NR] }')
+sed '/^\/run\/beamOn/,$d' reproducibility.mac > reproducibility_replay.mac
+echo "/microyz/random/replayVerbose 1" >> reproducibility_replay.mac
+echo "/microyz/random/replay $ids" >> reproducibility_replay.mac
+if ! "$exe" -t 4 -m reproducibility_replay.mac > reproducibility_replay.out; then
+  echo "reproducibility: replay failed, see reproducibility_replay.out"
+  exit 1
+fi
+
+for output in $records; do
+  if [ -z "$(deposits ${output}_replay.txt)" ]; then
+    echo "reproducibility: replayed events $ids have no deposit in ${output}_replay.txt"
+    status=1
+  elif cmp -s <(events ${output}_threads1.txt "$ids") \
+              <(events ${output}_replay.txt "$ids"); then
+    echo "reproducibility: replayed events $ids identical in $output.txt"
+  else
+    echo "reproducibility: replayed events $ids differ from the run in $output.txt"
+    status=1
+  fi
+done
+
+exit $status
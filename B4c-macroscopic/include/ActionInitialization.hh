@@ -32,10 +32,19 @@
 
 #include "G4VUserActionInitialization.hh"
 
+namespace B4
+{
+class SharedRunData;
+}
+
 namespace B4c
 {
 
 /// Action initialization class.
+///
+/// It owns the SharedRunData of the run, common to all threads. For every
+/// thread it creates a RunData, which the RunAction owns, and passes both
+/// to the actions of the thread.
 
 class ActionInitialization : public G4VUserActionInitialization
 {
@@ -45,6 +54,9 @@ class ActionInitialization : public G4VUserActionInitialization
 
     void BuildForMaster() const override;
     void Build() const override;
+
+  private:
+    B4::SharedRunData* fSharedRunData = nullptr;
 };
 
 }
@@ -0,0 +1,113 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file CalorHitStore.hh
+/// \brief Definition of the B4c::CalorHitStore class
+
+#ifndef B4cCalorHitStore_h
+#define B4cCalorHitStore_h 1
+
+#include "CalorHit.hh"
+
+#include <vector>
+
+namespace B4c
+{
+
+/// Hits of the cells of one thread, reused from event to event
+///
+/// CalorimeterSD accounts the steps of an event in the CalorHitStore of its
+/// thread instead of allocating a hits collection and its hits for every
+/// event. The store is sparse: it keeps a slot index per cell (-1 if the
+/// cell is untouched) and a pool with one hit per cell touched in the event,
+/// plus one hit for the total over all cells. The pool only grows to the
+/// largest number of cells touched in one event and is reused afterwards;
+/// Reset() clears the total and the hits of the cells touched in the
+/// previous event only, so the cost per event does not grow with the number
+/// of cells. The hit of a cell is found by its index, the copy number of
+/// the cell.
+///
+/// A hits collection of the event is only made from the store when it is
+/// asked for (see CalorimeterSD::EndOfEvent()).
+
+class CalorHitStore
+{
+  public:
+    CalorHitStore(G4int nofCells);
+    ~CalorHitStore() = default;
+
+    // Clear the hits of the previous event
+    void Reset();
+
+    // Hit of a cell, marked as touched in this event
+    // (the reference is valid until the next call)
+    inline CalorHit& Touch(G4int cell);
+
+    CalorHit& GetTotalHit() { return fTotalHit; }
+    const CalorHit& GetTotalHit() const { return fTotalHit; }
+    inline const CalorHit& GetCellHit(G4int cell) const;
+    G4int GetNofCells() const { return G4int(fCellSlots.size()); }
+
+    // Cells touched in this event, in the order of their first step
+    const std::vector<G4int>& GetTouchedCells() const { return fTouchedCells; }
+
+  private:
+    // Hits reserved in the pool up front, it grows beyond when needed
+    static constexpr G4int kPoolReserve = 1024;
+
+    CalorHit fTotalHit;
+    CalorHit fEmptyHit;                // returned for untouched cells
+    std::vector<G4int> fCellSlots;     // per cell, slot in fHitPool or -1
+    std::vector<CalorHit> fHitPool;    // hits of the touched cells, by slot
+    std::vector<G4int> fTouchedCells;  // per slot, the cell
+};
+
+// inline functions
+
+inline CalorHit& CalorHitStore::Touch(G4int cell)
+{
+  auto& slot = fCellSlots[cell];
+  if ( slot < 0 ) {
+    // Take the next slot of the pool, the hits of reused slots were
+    // cleared by Reset()
+    slot = G4int(fTouchedCells.size());
+    fTouchedCells.push_back(cell);
+    if ( slot == G4int(fHitPool.size()) ) fHitPool.emplace_back();
+  }
+  return fHitPool[slot];
+}
+
+inline const CalorHit& CalorHitStore::GetCellHit(G4int cell) const
+{
+  auto slot = fCellSlots[cell];
+  return ( slot < 0 ) ? fEmptyHit : fHitPool[slot];
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
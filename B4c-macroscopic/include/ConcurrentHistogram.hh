@@ -0,0 +1,115 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ConcurrentHistogram.hh
+/// \brief Definition of the B4::ConcurrentHistogram class
+
+#ifndef B4ConcurrentHistogram_h
+#define B4ConcurrentHistogram_h 1
+
+#include "globals.hh"
+
+#include <atomic>
+#include <vector>
+
+namespace B4
+{
+
+/// Histogram shared by all threads of a run, readable while the run goes on
+///
+/// Every thread fills its own row of sums, aligned to cache lines so that
+/// the threads do not write to the same cache line. A row holds the number
+/// of entries, the sums of w, w^2, w x, w x^2, w^2 x and w^2 x^2 and the
+/// sums of weights of the bins (underflow, nofBins bins of [xmin, xmax),
+/// overflow). With nofBins = 0 only the sums are kept.
+///
+/// GetSnapshot() adds up the rows of all threads with relaxed atomic loads,
+/// any thread can read the statistics of the whole run at any time without
+/// locks and without waiting for the merge at the end of the run. A snapshot
+/// taken during the run may miss parts of the events being added.
+///
+/// Reset() sizes the rows for the threads of the run, it is called by the
+/// master before the workers start (BeginOfRunAction()).
+
+class ConcurrentHistogram
+{
+  public:
+    ConcurrentHistogram(G4int nofBins = 0, G4double xmin = 0., G4double xmax = 1.);
+    ~ConcurrentHistogram() = default;
+
+    // Clear the sums, one row per thread of the run (master only)
+    void Reset();
+
+    // Add x with weight to the row of the calling thread
+    void Fill(G4double x, G4double weight = 1.);
+
+    // Sums over all threads
+    struct Snapshot {
+      G4long   nofEntries = 0;
+      G4double sumW = 0.;
+      G4double sumW2 = 0.;
+      G4double sumWX = 0.;
+      G4double sumWX2 = 0.;
+      G4double sumW2X = 0.;
+      G4double sumW2X2 = 0.;
+      std::vector<G4double> bins;  // underflow, bins, overflow
+
+      G4double GetMean() const;
+      G4double GetMeanError() const;  // standard error of the weighted mean
+    };
+    Snapshot GetSnapshot() const;
+
+    G4int    GetNofBins() const { return fNofBins; }
+    G4double GetXmin() const { return fXmin; }
+    G4double GetXmax() const { return fXmax; }
+
+  private:
+    enum { kNofEntries, kSumW, kSumW2, kSumWX, kSumWX2, kSumW2X, kSumW2X2,
+           kNofSums };
+
+    // Values of one cache line
+    struct alignas(64) Line {
+      static constexpr G4int kSize = 64 / sizeof(std::atomic<G4double>);
+      Line();
+      std::atomic<G4double> value[kSize];
+    };
+
+    std::atomic<G4double>& Value(G4int row, G4int index);
+    const std::atomic<G4double>& Value(G4int row, G4int index) const;
+
+    G4int    fNofBins = 0;
+    G4double fXmin = 0.;
+    G4double fXmax = 1.;
+    G4int    fNofRows = 1;
+    G4int    fLinesPerRow = 1;
+    std::vector<Line> fLines;
+};
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
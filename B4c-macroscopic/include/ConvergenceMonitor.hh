@@ -0,0 +1,124 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ConvergenceMonitor.hh
+/// \brief Definition of the B4::ConvergenceMonitor class
+
+#ifndef B4ConvergenceMonitor_h
+#define B4ConvergenceMonitor_h 1
+
+#include "ConcurrentHistogram.hh"
+#include "globals.hh"
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+namespace B4
+{
+
+/// Statistical convergence monitor for early termination of a run
+///
+/// One monitor is shared by all threads (see SharedRunData). Each thread adds
+/// the per-event observables to its ConcurrentHistogram sums. Every
+/// kBatchSize events of the run the relative standard error of the mean of
+/// the selected observables is computed from a snapshot of the sums, without
+/// locking the other threads; once all of them are below the target
+/// precision the run is flagged as converged and EventAction aborts the
+/// event loop of each thread (AbortRun(true)).
+///
+/// Observables per event:
+/// - edep        : energy deposit in the sensitive detector
+/// - ionYield    : cluster size (number of ionisations)
+/// - hitFraction : fraction of events with energy deposit
+/// - F2          : fraction of events with cluster size >= 2 (an estimated,
+///                 non-integer cluster size between 1 and 2 counts with its
+///                 share of the bin 2, as in ClusterSizeAccumulator)
+///
+/// Events of a biased source enter with their weight (weight * observable),
+/// so the means and errors are those of the analog quantities.
+///
+/// The monitor is configured by the /microyz/convergence/ commands on the
+/// master and is disabled as long as the target precision is 0.
+
+class ConvergenceMonitor
+{
+  public:
+    enum Observable { kEdep, kIonYield, kHitFraction, kF2, kNofObservables };
+
+    ConvergenceMonitor();
+    ~ConvergenceMonitor() = default;
+
+    // Configuration
+    void SetTargetPrecision(G4double precision) { fTargetPrecision = precision; }
+    // Space separated names, unknown names leave the selection unchanged
+    void SetObservables(const G4String& names);
+    void SetMinEvents(G4long nofEvents) { fMinEvents = nofEvents; }
+    void SetReportInterval(G4long nofEvents) { fReportInterval = nofEvents; }
+    G4bool IsEnabled() const { return fTargetPrecision > 0.; }
+
+    // Reset the shared sums, called by the master at the start of the run
+    void BeginOfRun();
+
+    // Add the observables of one event of the calling thread with its weight
+    void AddEvent(G4double edep, G4double ionYield, G4double weight = 1.);
+
+    // Test the target precision with the events of all threads
+    void Check();
+
+    // Whether the target precision has been reached by the merged events
+    G4bool IsConverged() const { return fConverged; }
+
+    // Print the current means and relative standard errors (master only)
+    void Report() const;
+
+  private:
+    using Snapshots = std::array<ConcurrentHistogram::Snapshot, kNofObservables>;
+
+    Snapshots GetSnapshots() const;
+    static G4double RelativeError(const ConcurrentHistogram::Snapshot& sums);
+    static const char* GetName(G4int observable);
+    void PrintStatus(const Snapshots& snapshots) const;
+
+    static constexpr G4long kBatchSize = 100;
+
+    G4double fTargetPrecision = 0.;
+    std::vector<G4int> fObservables;
+    G4long fMinEvents = 1000;
+    G4long fReportInterval = 100000;
+
+    // Sums of the observables of all threads
+    std::array<ConcurrentHistogram, kNofObservables> fObservableSums;
+    std::atomic<G4long> fNofEvents { 0 };   // events added in this run
+    std::atomic<G4long> fNextReport { 0 };  // number of events of the next report
+    std::atomic<G4bool> fConverged { false };
+};
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,101 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file IonisationClassifier.hh
+/// \brief Definition of the B4::IonisationClassifier class
+
+#ifndef B4IonisationClassifier_h
+#define B4IonisationClassifier_h 1
+
+#include "globals.hh"
+#include "G4Track.hh"
+
+#include <algorithm>
+#include <vector>
+
+class G4VProcess;
+class G4ParticleDefinition;
+
+namespace B4
+{
+
+/// Classifies secondaries as ionisation electrons.
+///
+/// The process names or patterns ('*' matches any sequence, default "*Ioni*")
+/// are resolved to the G4VProcess objects of the calling thread by Resolve(),
+/// which has to be called at the start of each run. The per-step
+/// classification then only compares pointers.
+
+class IonisationClassifier
+{
+  public:
+    IonisationClassifier();
+    ~IonisationClassifier() = default;
+
+    // Space separated list of process names or patterns
+    void SetPatterns(const G4String& patterns);
+    G4String GetPatterns() const;
+
+    // Resolve the processes of this thread, call at the start of the run
+    void Resolve();
+    const std::vector<const G4VProcess*>& GetProcesses() const { return fProcesses; }
+
+    inline G4bool IsIonisationElectron(const G4Track* track) const;
+    inline G4int  CountIonisations(const std::vector<const G4Track*>* tracks) const;
+
+  private:
+    static G4bool Match(const char* pattern, const char* name);
+
+    std::vector<G4String>           fPatterns;
+    std::vector<const G4VProcess*>  fProcesses;
+    const G4ParticleDefinition*     fElectron = nullptr;
+};
+
+// inline functions
+
+inline G4bool IonisationClassifier::IsIonisationElectron(const G4Track* track) const
+{
+  if ( track->GetDefinition() != fElectron ) return false;
+  auto creator = track->GetCreatorProcess();
+  return creator != nullptr
+    && std::find(fProcesses.begin(), fProcesses.end(), creator) != fProcesses.end();
+}
+
+inline G4int IonisationClassifier::CountIonisations(
+                                   const std::vector<const G4Track*>* tracks) const
+{
+  G4int nIon = 0;
+  for ( auto track : *tracks ) {
+    if ( IsIonisationElectron(track) ) ++nIon;
+  }
+  return nIon;
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,134 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file JobPartition.hh
+/// \brief Definition of the B4::JobPartition class
+
+#ifndef B4JobPartition_h
+#define B4JobPartition_h 1
+
+#include "globals.hh"
+
+#include <string>
+#include <vector>
+
+class G4Run;
+
+namespace B4
+{
+
+/// Event numbering, per-event seeding and partition of a simulation into
+/// independent jobs
+///
+/// Events carry a global event ID which continues over the runs of the
+/// application: the events of the second run of 1000 events are 1000 to
+/// 1999. Each event is seeded from the master seed (/microyz/random/seed)
+/// and its global event ID by SplitMix64, so its random numbers do not
+/// depend on the thread, the batch or the job it is simulated in, nor on the
+/// number of threads or the run manager type. A single event is re-simulated
+/// with /microyz/random/replay. /microyz/random/perEventSeeds false restores
+/// the seeding of the run manager, the event IDs then restart with every
+/// run (outside of a partitioned run).
+///
+/// exampleB4c --job i/N runs job i of N. /microyz/job/beamOn gives each job
+/// its own contiguous range of events of the requested total. (With the
+/// plain /run/beamOn n, every job simulates n events, and job i covers the
+/// events [i n, (i+1) n) of the run.) The N jobs together therefore
+/// reproduce a single --job 0/1 run of the total number of events.
+///
+/// The outputs of a job carry the suffix _job<i>of<N> (data.txt -->
+/// data_job3of8.txt), so jobs never share a file, and start with a
+/// "# job" header line describing the event range. The mergeJobs program
+/// combines the outputs of the N jobs. With N = 1 the plain file names are
+/// used without the header. The outputs of a replay carry the suffix
+/// _replay, so they do not overwrite those of the run.
+///
+/// The state is written by the master only, before the workers start
+/// the run.
+
+class JobPartition
+{
+  public:
+    // Event range of one job, as written in the "# job" header lines
+    struct JobInfo {
+      G4int  index = 0;
+      G4int  count = 0;
+      G4int  runID = 0;
+      G4long firstEvent = 0;
+      G4long nofEvents = 0;
+      G4long seed = 0;
+    };
+
+    // Configure from the "i/N" argument of --job, false if malformed
+    static G4bool Configure(const G4String& spec);
+    static G4bool IsEnabled();
+    static G4int  GetIndex();
+    static G4int  GetCount();
+
+    // Master seed of the per-event random numbers, common to all jobs
+    static void   SetSeed(G4long seed);
+    static G4long GetSeed();
+
+    // Seed every event from its global event ID (default) or leave the
+    // seeding to the run manager
+    static void   SetPerEventSeeding(G4bool value);
+    static G4bool IsPerEventSeeding();
+
+    // Start a run with the share of this job of nofEvents (master only)
+    static void BeamOn(G4long nofEvents);
+
+    // Start a run re-simulating the given global event IDs with the given
+    // tracking verbose level (master only)
+    static void Replay(const std::vector<G4long>& eventIDs, G4int verboseLevel);
+    static G4bool IsReplaying();
+
+    // Fix the event range of the run, and count its events at the end,
+    // called by the master
+    static void BeginOfRun(const G4Run* run);
+    static void EndOfRun();
+
+    // Global ID of an event of the current run
+    static G4long GetGlobalEventID(G4int eventID);
+
+    // Seed the random engine of the calling thread for an event
+    static void SeedEvent(G4int eventID);
+
+    // Output file of this job, or of the given job (data.txt --> data_job3of8.txt)
+    static G4String FileName(const G4String& baseFileName);
+    static G4String FileName(const G4String& baseFileName, G4int index, G4int count);
+
+    // "# job" header line of the outputs of the current run (empty if N < 2)
+    static G4String Header();
+
+    // Read a "# job" header line, false if the line is not one
+    static G4bool ParseHeader(const std::string& line, JobInfo& info);
+};
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
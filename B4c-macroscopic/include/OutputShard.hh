@@ -0,0 +1,126 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file OutputShard.hh
+/// \brief Definition of the B4::OutputShard class
+
+#ifndef B4OutputShard_h
+#define B4OutputShard_h 1
+
+#include "globals.hh"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace B4
+{
+
+/// Buffered per-thread output file
+///
+/// Every thread writes its records into its own shard file
+/// (<name>_t<threadID>.<ext>) through a large memory buffer, so that a record
+/// costs one memcpy and the file is only touched when the buffer is full.
+/// The shards are registered by their base file name and merged into the
+/// base file by the master in MergeTextShards() at the end of the run.
+///
+/// Records must start with the event ID. Events are processed in increasing
+/// order within one thread, so the merge is a k-way merge on the event ID and
+/// the merged file does not depend on how events were scheduled on threads.
+/// The same merge combines the outputs of several jobs (MergeTextFiles()).
+
+class OutputShard
+{
+  public:
+    OutputShard(std::size_t bufferSize = 4*1024*1024);
+    ~OutputShard();
+
+    OutputShard(const OutputShard&) = delete;
+    OutputShard& operator=(const OutputShard&) = delete;
+
+    // Open/close the shard of the calling thread
+    void Open(const G4String& baseFileName);
+    void Close();
+    G4bool IsOpen() const;
+
+    // Append a record to the buffer
+    inline void Write(const char* data, std::size_t size);
+
+    // Merge all shards registered for baseFileName into baseFileName,
+    // starting the file with header (master only)
+    static void MergeTextShards(const G4String& baseFileName,
+                                const G4String& header);
+
+    // k-way merge of text files whose records start with the event ID into
+    // outFileName, starting the file with header; lines not starting with
+    // a digit (headers, comments) of the input files are skipped
+    static G4bool MergeTextFiles(const std::vector<G4String>& fileNames,
+                                 const G4String& outFileName,
+                                 const G4String& header);
+
+    // Take the shards registered for baseFileName during the run, ordered by
+    // thread ID (master only, for format specific merging)
+    static std::vector<G4String> TakeShards(const G4String& baseFileName);
+
+    // Name of the shard of the given thread
+    static G4String ShardFileName(const G4String& baseFileName, G4int threadID);
+
+  private:
+    void Flush();
+
+    std::FILE* fFile = nullptr;
+    std::vector<char> fBuffer;
+    std::size_t fUsed = 0;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4bool OutputShard::IsOpen() const
+{
+  return fFile != nullptr;
+}
+
+// Copies the record into the buffer, writing the buffer out only when full
+inline void OutputShard::Write(const char* data, std::size_t size)
+{
+  if ( ! fFile ) return;
+
+  if ( fUsed + size > fBuffer.size() ) {
+    Flush();
+    if ( size > fBuffer.size() ) {
+      std::fwrite(data, 1, size, fFile);
+      return;
+    }
+  }
+  std::memcpy(fBuffer.data() + fUsed, data, size);
+  fUsed += size;
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,169 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhaseSpaceFormat.hh
+/// \brief Definition of the binary phase-space file format
+
+#ifndef B4PhaseSpaceFormat_h
+#define B4PhaseSpaceFormat_h 1
+
+// No Geant4 dependency: the layout can be read by external tools
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace B4
+{
+
+/// Binary phase-space file
+///
+/// The file starts with a fixed size header:
+/// - char[8]  magic "B4CPHSP" (null terminated)
+/// - uint32   format version
+/// - uint32   byte order mark 0x01020304 (written in host order)
+/// - uint32   record size in bytes
+/// - uint32   reserved (0)
+/// - uint64   number of source events of the capture run
+/// - float64  z of the capture plane (mm)
+///
+/// followed by fixed-width records ordered by event ID:
+/// int64 event ID, int32 PDG code, float32 kinetic energy (MeV),
+/// float32 x, y, z (mm), float32 direction x, y, z and float32 weight.
+/// All particles of one source event are replayed as one event.
+/// Version 2 widened the event ID from int32, global event IDs of long
+/// partitioned runs exceed its range.
+
+namespace PhaseSpaceFormat
+{
+  constexpr char kMagic[8] = { 'B', '4', 'C', 'P', 'H', 'S', 'P', '\0' };
+  constexpr std::uint32_t kVersion = 2;
+  constexpr std::uint32_t kByteOrderMark = 0x01020304;
+  constexpr std::size_t kHeaderSize
+    = sizeof(kMagic) + 4*sizeof(std::uint32_t) + sizeof(std::uint64_t)
+      + sizeof(double);
+  constexpr std::size_t kRecordSize
+    = sizeof(std::int64_t) + sizeof(std::int32_t) + 8*sizeof(float);
+
+  struct Header {
+    std::uint32_t version = 0;
+    std::uint32_t recordSize = 0;
+    std::uint64_t nofSourceEvents = 0;
+    double planeZ = 0.;
+  };
+
+  struct Record {
+    std::int64_t eventID = 0;
+    std::int32_t pdg = 0;
+    float energy = 0.f;
+    float position[3] = { 0.f, 0.f, 0.f };
+    float direction[3] = { 0.f, 0.f, 0.f };
+    float weight = 1.f;
+  };
+
+  // Header bytes (kHeaderSize) of a file
+  inline std::string EncodeHeader(std::uint64_t nofSourceEvents, double planeZ)
+  {
+    std::string header(kMagic, sizeof(kMagic));
+    auto put = [&header](const auto& value) {
+      header.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    put(kVersion);
+    put(kByteOrderMark);
+    put(static_cast<std::uint32_t>(kRecordSize));
+    put(std::uint32_t(0));
+    put(nofSourceEvents);
+    put(planeZ);
+    return header;
+  }
+
+  // Checks and decodes the header at data (at least kHeaderSize bytes),
+  // returns false if it is not a phase-space file of this version written
+  // on a machine with the same byte order
+  inline bool DecodeHeader(const char* data, Header& header)
+  {
+    if ( std::memcmp(data, kMagic, sizeof(kMagic)) != 0 ) return false;
+    data += sizeof(kMagic);
+
+    auto get = [&data](auto& value) {
+      std::memcpy(&value, data, sizeof(value));
+      data += sizeof(value);
+    };
+    std::uint32_t byteOrderMark = 0;
+    std::uint32_t reserved = 0;
+    get(header.version);
+    get(byteOrderMark);
+    get(header.recordSize);
+    get(reserved);
+    get(header.nofSourceEvents);
+    get(header.planeZ);
+    return byteOrderMark == kByteOrderMark
+      && header.version == kVersion
+      && header.recordSize == kRecordSize;
+  }
+
+  // Packs one record into out (kRecordSize bytes)
+  inline void EncodeRecord(char* out, const Record& record)
+  {
+    auto put = [&out](const auto& value) {
+      std::memcpy(out, &value, sizeof(value));
+      out += sizeof(value);
+    };
+    put(record.eventID);
+    put(record.pdg);
+    put(record.energy);
+    for ( auto value : record.position ) put(value);
+    for ( auto value : record.direction ) put(value);
+    put(record.weight);
+  }
+
+  // Unpacks one record from data (kRecordSize bytes)
+  inline void DecodeRecord(const char* data, Record& record)
+  {
+    auto get = [&data](auto& value) {
+      std::memcpy(&value, data, sizeof(value));
+      data += sizeof(value);
+    };
+    get(record.eventID);
+    get(record.pdg);
+    get(record.energy);
+    for ( auto& value : record.position ) get(value);
+    for ( auto& value : record.direction ) get(value);
+    get(record.weight);
+  }
+
+  // Event ID of the record at data
+  inline std::int64_t EventID(const char* data)
+  {
+    std::int64_t eventID = 0;
+    std::memcpy(&eventID, data, sizeof(eventID));
+    return eventID;
+  }
+}
+
+}
+
+#endif
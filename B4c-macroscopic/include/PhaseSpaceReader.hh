@@ -0,0 +1,93 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhaseSpaceReader.hh
+/// \brief Definition of the B4::PhaseSpaceReader class
+
+#ifndef B4PhaseSpaceReader_h
+#define B4PhaseSpaceReader_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <map>
+
+class G4Event;
+class G4ParticleDefinition;
+
+namespace B4
+{
+
+/// Replays a phase-space file written by PhaseSpaceWriter
+///
+/// The file is memory-mapped once per process and shared read-only by all
+/// threads. Event i of the run replays all particles of the source event
+/// i % N, N being the number of source events with particles in the file,
+/// so the primaries of an event do not depend on the thread processing it.
+/// The file is recycled for the given number of passes (0 = unlimited),
+/// afterwards GeneratePrimaries() returns false.
+///
+/// The particles can be shifted (e.g. to the upstream face of another
+/// detector geometry) and, for axially symmetric beams, rotated about the z
+/// axis by a random angle in every event.
+
+class PhaseSpaceReader
+{
+  public:
+    PhaseSpaceReader() = default;
+    ~PhaseSpaceReader() = default;
+
+    void SetFileName(const G4String& fileName);
+    void SetNofPasses(G4int nofPasses) { fNofPasses = nofPasses; }
+    void SetShift(const G4ThreeVector& shift) { fShift = shift; }
+    void SetRandomRotation(G4bool value) { fRandomRotation = value; }
+
+    G4bool IsEnabled() const { return ! fFileName.empty(); }
+
+    // Add the particles of the source event as primary vertices,
+    // false if the passes over the file are exhausted
+    G4bool GeneratePrimaries(G4Event* event);
+
+  private:
+    struct Mapping;
+    static const Mapping* Map(const G4String& fileName);
+
+    const G4ParticleDefinition* FindParticle(G4int pdg);
+
+    G4String fFileName;
+    const Mapping* fMapping = nullptr;
+    G4int fNofPasses = 1;
+    G4ThreeVector fShift;
+    G4bool fRandomRotation = false;
+
+    std::map<G4int, const G4ParticleDefinition*> fParticles;
+};
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
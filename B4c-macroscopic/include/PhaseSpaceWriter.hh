@@ -0,0 +1,100 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhaseSpaceWriter.hh
+/// \brief Definition of the B4::PhaseSpaceWriter class
+
+#ifndef B4PhaseSpaceWriter_h
+#define B4PhaseSpaceWriter_h 1
+
+#include "globals.hh"
+#include "G4Step.hh"
+
+#include "OutputShard.hh"
+
+namespace B4
+{
+
+/// Phase-space capture at a plane upstream of the sensitive detectors
+///
+/// Particles crossing the plane z = const in +z direction are written with
+/// their event ID into a binary record stream (PhaseSpaceFormat.hh) and then
+/// killed, so nothing downstream of the plane is simulated. Each thread
+/// writes its own OutputShard, the master merges the shards in Merge() in
+/// event ID order.
+///
+/// The crossing point is interpolated on the step, it is exact when the plane
+/// coincides with a volume boundary. The file is replayed with
+/// PhaseSpaceReader (/microyz/source/ commands).
+
+class PhaseSpaceWriter
+{
+  public:
+    PhaseSpaceWriter() = default;
+    ~PhaseSpaceWriter() = default;
+
+    PhaseSpaceWriter(const PhaseSpaceWriter&) = delete;
+    PhaseSpaceWriter& operator=(const PhaseSpaceWriter&) = delete;
+
+    // Set methods, applied at the next Open()
+    void SetFileName(const G4String& fileName) { fFileName = fileName; }
+    void SetPlane(G4double z) { fPlaneZ = z; }
+
+    G4bool IsEnabled() const { return ! fFileName.empty(); }
+    G4bool IsOpen() const { return fShard.IsOpen(); }
+
+    // Open/close the shard of the calling thread
+    void Open();
+    void Close();
+
+    // Merge the shards of all threads into the phase-space file (master only)
+    void Merge(G4long nofSourceEvents) const;
+
+    // True if the step crosses the plane in +z direction
+    inline G4bool Crosses(const G4Step* step) const;
+
+    // Write the particle at the crossing point
+    void Write(const G4Step* step, G4long eventID);
+
+  private:
+    OutputShard fShard;
+    G4String fFileName;
+    G4double fPlaneZ = 0.;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4bool PhaseSpaceWriter::Crosses(const G4Step* step) const
+{
+  return step->GetPreStepPoint()->GetPosition().z() < fPlaneZ
+    && step->GetPostStepPoint()->GetPosition().z() >= fPlaneZ;
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
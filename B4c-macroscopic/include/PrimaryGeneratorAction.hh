@@ -33,6 +33,8 @@
 #include "G4VUserPrimaryGeneratorAction.hh"
 #include "globals.hh"
 
+#include "PhaseSpaceReader.hh"
+
 // GPS is more advanced than G4ParticleHGun
 class G4GeneralParticleSource;
 class G4Event;
@@ -40,12 +42,18 @@ class G4Event;
 namespace B4
 {
 
+class PrimaryGeneratorMessenger;
+
 /// The primary generator action class with particle gum.
 ///
 /// It defines a single particle which hits the calorimeter
 /// perpendicular to the input face. The type of the particle
 /// can be changed via the G4 build-in commands of G4ParticleGun class
 /// (see the macros provided with this example).
+///
+/// With /microyz/source/phaseSpaceFile set, the primaries are read from a
+/// phase-space file (PhaseSpaceReader) instead, and the run is stopped when
+/// the requested passes over the file are exhausted.
 
 class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 {
@@ -61,6 +69,10 @@ public:
 private:
   // Member variable, storing the GPS instance which encapsules e.g. position, energy, direction...
   G4GeneralParticleSource* fParticleGun = nullptr;
+
+  // Replay of a phase-space file, replaces the GPS when enabled
+  PhaseSpaceReader fPhaseSpaceReader;
+  PrimaryGeneratorMessenger* fMessenger = nullptr;
 };
 
 }
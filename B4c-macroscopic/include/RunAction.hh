@@ -33,13 +33,14 @@
 #include "G4UserRunAction.hh"
 #include "globals.hh"
 
-#include <fstream>
-
 class G4Run;
 
 namespace B4
 {
 
+class RunData;
+class RunActionMessenger;
+
 /// Run action class
 ///
 /// It accumulates statistic and computes dispersion of the energy deposit
@@ -55,23 +56,69 @@ namespace B4
 /// In EndOfRunAction(), the accumulated statistic and computed
 /// dispersion is printed.
 ///
+/// The data of the run of each thread are kept in its RunData, created by
+/// ActionInitialization and shared with the other actions of the thread;
+/// the state shared by all threads is kept in the SharedRunData.
+///
+/// The per-event records (data.txt) are written by each worker into its own
+/// buffered OutputShard and merged by the master in EndOfRunAction().
+///
+/// The ionisation processes counted by CalorimeterSD are resolved by the
+/// IonisationClassifier of each thread in BeginOfRunAction().
+///
+/// The ionisation cluster-size distribution of the events is accumulated in
+/// a ClusterSizeAccumulator, merged over the threads and written to
+/// cluster_size.txt by the master. The per-event text records can then be
+/// switched off with /microyz/output/eventRecords for production runs.
+/// The cluster sizes are also filled into a ConcurrentHistogram shared by
+/// all threads, from which the progress report reads M1 and F2 during the
+/// run.
+///
+/// With a target precision set (/microyz/convergence/ commands) the run is
+/// stopped once the relative standard errors of the selected observables,
+/// merged over all threads by the ConvergenceMonitor, are below the target.
+///
+/// The progress of the run is printed by a time based ProgressReporter
+/// (/microyz/progress/ commands) instead of a line per event.
+///
+/// The steps passing each stage of CalorimeterSD::ProcessHits() are counted
+/// in accumulables and reported by the master in EndOfRunAction().
+///
+/// With weighted events the master also reports the effective number of
+/// events, the efficiency gain of M1 and the events whose track weights
+/// differ from the event weight (see CalorHit::GetEventValues()).
+///
+/// The per-step energy deposits are written by CalorimeterSD through the
+/// StepOutput of the thread, as text or binary records (/microyz/output/
+/// commands).
+///
+/// With /microyz/output/phaseSpaceFile set, the particles crossing the capture
+/// plane are written by SteppingAction through the PhaseSpaceWriter and the
+/// master merges the shards of the threads into the phase-space file.
+///
+/// In a job of a partitioned run (exampleB4c --job i/N) the master fixes the
+/// global event IDs of the run in BeginOfRunAction() and the outputs are
+/// written under the file names of the job (see JobPartition), together
+/// with the exact cluster-size sums (cluster_size_sums_job<i>of<N>.txt) which
+/// mergeJobs combines.
+///
+/// The master counts the events of the run at the end of EndOfRunAction(),
+/// the global event IDs, and hence the per-event seeds, of the next run
+/// continue after them.
+///
 
 class RunAction : public G4UserRunAction
 {
   public:
-    RunAction();
+    RunAction(RunData* runData);
     ~RunAction() override;
 
     void BeginOfRunAction(const G4Run*) override;
     void   EndOfRunAction(const G4Run*) override;
 
-    // Declaration of function giving access to output file
-    std::ofstream& GetOutputFile() const;
-
   private:
-   // Declaration of actual file for per-step data
-   // mutable allow us to modify outFile even though it is marked const
-   mutable std::ofstream outFile;
+    RunData* fRunData = nullptr;  // of this thread, owned
+    RunActionMessenger* fMessenger = nullptr;
 };
 
 }
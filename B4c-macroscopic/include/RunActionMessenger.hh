@@ -0,0 +1,111 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file RunActionMessenger.hh
+/// \brief Definition of the B4::RunActionMessenger class
+
+#ifndef B4RunActionMessenger_h
+#define B4RunActionMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithABool;
+class G4UIcmdWithADouble;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+
+namespace B4
+{
+
+class RunData;
+
+/// Messenger of the run action
+///
+/// /microyz/output/ commands select the per-event and per-step output and the
+/// phase-space capture,
+/// /microyz/scoring/ commands configure what CalorimeterSD counts and keeps,
+/// /microyz/convergence/ commands configure the early stop of the run,
+/// /microyz/progress/ commands configure the progress report,
+/// /microyz/job/ commands run the share of this job of a partitioned run,
+/// /microyz/random/ commands configure the per-event seeding and replay
+/// single events.
+///
+/// The commands configure the RunData of the thread, the convergence and
+/// progress commands the SharedRunData of all threads; these are only
+/// applied on the master.
+
+class RunActionMessenger : public G4UImessenger
+{
+  public:
+    RunActionMessenger(RunData* runData);
+    ~RunActionMessenger() override;
+
+    void SetNewValue(G4UIcommand* command, G4String newValue) override;
+
+  private:
+    RunData*                    fRunData = nullptr;
+
+    G4UIdirectory*              fOutputDir = nullptr;
+    G4UIcmdWithAString*         fStepFormatCmd = nullptr;
+    G4UIcmdWithABool*           fDeltaEventIDCmd = nullptr;
+    G4UIcmdWithABool*           fEventRecordsCmd = nullptr;
+    G4UIcmdWithABool*           fFullPrecisionCmd = nullptr;
+    G4UIcmdWithAString*         fPhaseSpaceFileCmd = nullptr;
+    G4UIcmdWithADoubleAndUnit*  fPhaseSpacePlaneCmd = nullptr;
+
+    G4UIdirectory*              fScoringDir = nullptr;
+    G4UIcmdWithAString*         fIonisationProcessesCmd = nullptr;
+    G4UIcmdWithABool*           fHitsCollectionCmd = nullptr;
+
+    G4UIdirectory*              fConvergenceDir = nullptr;
+    G4UIcmdWithADouble*         fPrecisionCmd = nullptr;
+    G4UIcmdWithAString*         fObservablesCmd = nullptr;
+    G4UIcmdWithAnInteger*       fMinEventsCmd = nullptr;
+    G4UIcmdWithAnInteger*       fReportIntervalCmd = nullptr;
+
+    G4UIdirectory*              fProgressDir = nullptr;
+    G4UIcmdWithADoubleAndUnit*  fProgressIntervalCmd = nullptr;
+    G4UIcmdWithAnInteger*       fProgressVerboseCmd = nullptr;
+
+    G4UIdirectory*              fJobDir = nullptr;
+    G4UIcmdWithAnInteger*       fJobBeamOnCmd = nullptr;
+
+    G4UIdirectory*              fRandomDir = nullptr;
+    G4UIcmdWithAnInteger*       fSeedCmd = nullptr;
+    G4UIcmdWithABool*           fPerEventSeedsCmd = nullptr;
+    G4UIcmdWithAString*         fReplayCmd = nullptr;
+    G4UIcmdWithAnInteger*       fReplayVerboseCmd = nullptr;
+    G4int                       fReplayVerboseLevel = 1;
+};
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
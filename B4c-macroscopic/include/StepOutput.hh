@@ -0,0 +1,113 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StepOutput.hh
+/// \brief Definition of the B4::StepOutput class
+
+#ifndef B4StepOutput_h
+#define B4StepOutput_h 1
+
+#include "globals.hh"
+
+#include "OutputShard.hh"
+#include "StepRecordFormat.hh"
+
+#include <cstdio>
+
+namespace B4
+{
+
+/// Per-step energy deposit output
+///
+/// Writes eventID, z, x, y (nm) and energy deposit (keV) of every step with
+/// an energy deposit either as ';' separated text (braggcurve_data.txt) or as
+/// a binary record stream (braggcurve_data.bin) described in
+/// StepRecordFormat.hh. The format is selected with
+/// /microyz/output/stepFormat and /microyz/output/deltaEventID.
+///
+/// Each thread writes its own OutputShard (braggcurve_data_t<N>.txt/.bin,
+/// no header, absolute event IDs). The master merges the shards in Merge()
+/// in event ID order, writing the header and the delta encoding, so the
+/// merged file does not depend on the number of threads.
+
+class StepOutput
+{
+  public:
+    enum class Format { kText, kBinary };
+
+    StepOutput() = default;
+    ~StepOutput() = default;
+
+    StepOutput(const StepOutput&) = delete;
+    StepOutput& operator=(const StepOutput&) = delete;
+
+    // Set methods, applied at the next Open()/Merge()
+    void SetFormat(Format format);
+    void SetDeltaEventID(G4bool value);
+
+    // Open/close the shard of the calling thread
+    void Open(const G4String& baseName);
+    void Close();
+
+    // Merge the shards of all threads into the output file (master only)
+    void Merge(const G4String& baseName) const;
+
+    // Write one step
+    inline void Write(G4long eventID,
+                      G4double z, G4double x, G4double y, G4double edep);
+
+  private:
+    G4String FileName(const G4String& baseName) const;
+    void MergeBinary(const G4String& fileName) const;
+
+    OutputShard fShard;
+    Format fFormat = Format::kText;
+    G4bool fDeltaEventID = false;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void StepOutput::Write(G4long eventID,
+                              G4double z, G4double x, G4double y, G4double edep)
+{
+  if ( fFormat == Format::kBinary ) {
+    char record[StepRecordFormat::kRecordSize];
+    StepRecordFormat::EncodeRecord(record, eventID, z, x, y, edep);
+    fShard.Write(record, sizeof(record));
+  }
+  else {
+    char record[128];
+    auto size = std::snprintf(record, sizeof(record), "%ld;%g;%g;%g;%g\n",
+                              eventID, z, x, y, edep);
+    fShard.Write(record, size);
+  }
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
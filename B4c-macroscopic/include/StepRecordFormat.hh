@@ -0,0 +1,168 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StepRecordFormat.hh
+/// \brief Definition of the binary per-step record format
+
+#ifndef B4StepRecordFormat_h
+#define B4StepRecordFormat_h 1
+
+// No Geant4 dependency: this header is shared with the stepbin2csv reader
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace B4
+{
+
+/// Binary per-step record stream
+///
+/// The file starts with a self-describing header:
+/// - char[8]  magic "B4CSTEP" (null terminated)
+/// - uint32   format version
+/// - uint32   byte order mark 0x01020304 (written in host order)
+/// - uint32   flags (kDeltaEventID: event IDs are stored as the difference
+///            to the event ID of the previous record)
+/// - uint32   number of columns
+/// - uint32   record size in bytes
+/// - per column: char type ('i' int32, 'l' int64, 'f' float32) and
+///   char[15] name
+///
+/// followed by fixed-width records of int64 event ID and float32
+/// z, x, y (nm) and energy deposit (keV). Version 1 stored the event ID as
+/// int32, global event IDs of long partitioned runs exceed its range.
+
+namespace StepRecordFormat
+{
+  constexpr char kMagic[8] = { 'B', '4', 'C', 'S', 'T', 'E', 'P', '\0' };
+  constexpr std::uint32_t kVersion = 2;
+  constexpr std::uint32_t kByteOrderMark = 0x01020304;
+  constexpr std::uint32_t kDeltaEventID = 1u << 0;
+  constexpr std::size_t kNameLength = 15;
+  constexpr std::size_t kRecordSize = sizeof(std::int64_t) + 4*sizeof(float);
+
+  struct Column {
+    char type;
+    const char* name;
+  };
+  constexpr Column kColumns[] = {
+    { 'l', "EventID" },
+    { 'f', "z(nm)" },
+    { 'f', "x(nm)" },
+    { 'f', "y(nm)" },
+    { 'f', "Energy(keV)" }
+  };
+  constexpr std::uint32_t kNofColumns = sizeof(kColumns)/sizeof(Column);
+
+  struct Header {
+    std::uint32_t version = 0;
+    std::uint32_t flags = 0;
+    std::uint32_t recordSize = 0;
+    std::vector<char> types;
+    std::vector<std::string> names;
+  };
+
+  // Header bytes for a stream written with the given flags
+  inline std::string EncodeHeader(std::uint32_t flags)
+  {
+    std::string header(kMagic, sizeof(kMagic));
+    auto put = [&header](std::uint32_t value) {
+      header.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    put(kVersion);
+    put(kByteOrderMark);
+    put(flags);
+    put(kNofColumns);
+    put(static_cast<std::uint32_t>(kRecordSize));
+    for ( const auto& column : kColumns ) {
+      char name[kNameLength] = {};
+      std::strncpy(name, column.name, kNameLength - 1);
+      header.push_back(column.type);
+      header.append(name, kNameLength);
+    }
+    return header;
+  }
+
+  // Reads and checks the header, returns false if the stream is not a
+  // per-step record stream written on a machine with the same byte order
+  inline bool DecodeHeader(std::istream& in, Header& header)
+  {
+    char magic[sizeof(kMagic)];
+    if ( ! in.read(magic, sizeof(magic)) ) return false;
+    if ( std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ) return false;
+
+    std::uint32_t byteOrderMark = 0;
+    std::uint32_t nofColumns = 0;
+    auto get = [&in](std::uint32_t& value) {
+      return static_cast<bool>(
+        in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    };
+    if ( ! ( get(header.version) && get(byteOrderMark) && get(header.flags)
+             && get(nofColumns) && get(header.recordSize) ) ) return false;
+    if ( byteOrderMark != kByteOrderMark ) return false;
+
+    header.types.clear();
+    header.names.clear();
+    for ( std::uint32_t i = 0; i < nofColumns; ++i ) {
+      char type = 0;
+      char name[kNameLength + 1] = {};
+      if ( ! in.get(type) || ! in.read(name, kNameLength) ) return false;
+      header.types.push_back(type);
+      header.names.emplace_back(name);
+    }
+    return true;
+  }
+
+  // Size in bytes of a column of the given type, 0 if unknown
+  inline std::size_t ColumnSize(char type)
+  {
+    switch ( type ) {
+      case 'i': return sizeof(std::int32_t);
+      case 'l': return sizeof(std::int64_t);
+      case 'f': return sizeof(float);
+      default:  return 0;
+    }
+  }
+
+  // Packs one record into out (kRecordSize bytes)
+  inline void EncodeRecord(char* out, std::int64_t eventID,
+                           float z, float x, float y, float edep)
+  {
+    std::memcpy(out, &eventID, sizeof(eventID));
+    out += sizeof(eventID);
+    for ( float value : { z, x, y, edep } ) {
+      std::memcpy(out, &value, sizeof(value));
+      out += sizeof(value);
+    }
+  }
+}
+
+}
+
+#endif
@@ -0,0 +1,65 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SteppingAction.hh
+/// \brief Definition of the B4c::SteppingAction class
+
+#ifndef B4cSteppingAction_h
+#define B4cSteppingAction_h 1
+
+#include "G4UserSteppingAction.hh"
+#include "globals.hh"
+
+namespace B4
+{
+class RunData;
+}
+
+namespace B4c
+{
+
+/// Stepping action class
+///
+/// With /microyz/output/phaseSpaceFile set, particles crossing the capture
+/// plane are written to the phase space (B4::PhaseSpaceWriter) and killed.
+
+class SteppingAction : public G4UserSteppingAction
+{
+  public:
+    SteppingAction(B4::RunData* runData) : fRunData(runData) {}
+    ~SteppingAction() override = default;
+
+    void UserSteppingAction(const G4Step* step) override;
+
+  private:
+    B4::RunData* fRunData = nullptr;  // of this thread
+};
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
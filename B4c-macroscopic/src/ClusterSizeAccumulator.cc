@@ -0,0 +1,282 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ClusterSizeAccumulator.cc
+/// \brief Implementation of the B4::ClusterSizeAccumulator class
+
+#include "ClusterSizeAccumulator.hh"
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace B4
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ClusterSizeAccumulator::ClusterSizeAccumulator(const G4String& name)
+ : G4VAccumulable(name)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ClusterSizeAccumulator::Merge(const G4VAccumulable& other)
+{
+  const auto& otherAccumulator
+    = static_cast<const ClusterSizeAccumulator&>(other);
+
+  if ( otherAccumulator.fCounts.size() > fCounts.size() ) {
+    fCounts.resize(otherAccumulator.fCounts.size(), 0);
+    fWeights.resize(otherAccumulator.fCounts.size(), 0.);
+  }
+  for ( std::size_t nu = 0; nu < otherAccumulator.fCounts.size(); ++nu ) {
+    fCounts[nu] += otherAccumulator.fCounts[nu];
+    fWeights[nu] += otherAccumulator.fWeights[nu];
+  }
+  fNofEvents += otherAccumulator.fNofEvents;
+  fNofEstimatedEvents += otherAccumulator.fNofEstimatedEvents;
+  fSumW += otherAccumulator.fSumW;
+  fSumW2 += otherAccumulator.fSumW2;
+  fSum += otherAccumulator.fSum;
+  fSum2 += otherAccumulator.fSum2;
+  fSumW2Nu += otherAccumulator.fSumW2Nu;
+  fSumW2Nu2 += otherAccumulator.fSumW2Nu2;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ClusterSizeAccumulator::Reset()
+{
+  fCounts.clear();
+  fWeights.clear();
+  fNofEvents = 0;
+  fNofEstimatedEvents = 0;
+  fSumW = 0.;
+  fSumW2 = 0.;
+  fSum = 0.;
+  fSum2 = 0.;
+  fSumW2Nu = 0.;
+  fSumW2Nu2 = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ClusterSizeAccumulator::GetNofEffectiveEvents() const
+{
+  return fSumW2 > 0. ? fSumW * fSumW / fSumW2 : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4long ClusterSizeAccumulator::GetCount(G4int clusterSize) const
+{
+  if ( clusterSize < 0 || clusterSize >= G4int(fCounts.size()) ) return 0;
+  return fCounts[clusterSize];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ClusterSizeAccumulator::GetProbability(G4int clusterSize) const
+{
+  if ( fSumW <= 0. ) return 0.;
+  if ( clusterSize < 0 || clusterSize >= G4int(fWeights.size()) ) return 0.;
+  return fWeights[clusterSize] / fSumW;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ClusterSizeAccumulator::GetM1() const
+{
+  return fSumW > 0. ? fSum / fSumW : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ClusterSizeAccumulator::GetM2() const
+{
+  return fSumW > 0. ? fSum2 / fSumW : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ClusterSizeAccumulator::GetM1Error() const
+{
+  // Variance of the weighted mean, sum w^2 (nu - M1)^2 / (sum w)^2,
+  // reduces to (M2 - M1^2) / N without weights
+  if ( fNofEvents < 2 ) return 0.;
+  auto m1 = GetM1();
+  auto variance = (fSumW2Nu2 - 2. * m1 * fSumW2Nu + m1 * m1 * fSumW2)
+                  / (fSumW * fSumW) * fNofEvents / (fNofEvents - 1);
+  return variance > 0. ? std::sqrt(variance) : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ClusterSizeAccumulator::GetM1Gain() const
+{
+  // Variance of M1 of an analog run with the same number of events,
+  // estimated from the weighted distribution
+  if ( fNofEvents < 2 ) return 0.;
+  auto m1 = GetM1();
+  auto analogVariance = (GetM2() - m1 * m1) / (fNofEvents - 1);
+  auto error = GetM1Error();
+  return error > 0. ? analogVariance / (error * error) : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ClusterSizeAccumulator::GetCumulative(G4int k) const
+{
+  if ( fSumW <= 0. ) return 0.;
+  if ( k < 0 ) k = 0;
+  G4double sum = 0.;
+  for ( std::size_t nu = k; nu < fWeights.size(); ++nu ) {
+    sum += fWeights[nu];
+  }
+  return sum / fSumW;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ClusterSizeAccumulator::Write(const G4String& fileName,
+                                   const G4String& header) const
+{
+  std::ofstream file(fileName);
+  if ( ! file ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open " << fileName << " for writing.";
+    G4Exception("ClusterSizeAccumulator::Write()",
+      "MyCode0009", JustWarning, msg);
+    return;
+  }
+
+  // Estimated cluster sizes only keep M1 unbiased
+  const char* approximate = IsExact() ? "" : " (approximate)";
+  file << header
+       << "# Ionisation cluster-size distribution of " << fNofEvents << " events\n";
+  if ( ! IsExact() ) {
+    file << "# APPROXIMATE: " << fNofEstimatedEvents << " events with track weights"
+         << " differing from the event weight (splitting, roulette) have an\n"
+         << "# estimated, non-integer cluster size shared between the neighbouring"
+         << " bins. M1 is unbiased,\n"
+         << "# P, M2, F1, F2 and F are not the nanodosimetric distribution.\n";
+  }
+  file << "# M1 = " << GetM1() << " +- " << GetM1Error() << "\n"
+       << "# M2 = " << GetM2() << approximate << "\n"
+       << "# F1 = " << GetCumulative(1) << approximate << "\n"
+       << "# F2 = " << GetCumulative(2) << approximate << "\n";
+  if ( IsWeighted() ) {
+    file << "# weighted events: effective number = " << GetNofEffectiveEvents()
+         << ", gain in the variance of M1 = " << GetM1Gain() << "\n";
+  }
+  file << ( IsExact() ? "ClusterSize\tEvents\tP\tF\n"
+                      : "ClusterSize\tEvents\tP_approx\tF_approx\n" );
+
+  // F_k accumulated from the tail, P and F from the weights
+  std::vector<G4double> tail(fWeights.size() + 1, 0.);
+  for ( std::size_t nu = fWeights.size(); nu-- > 0; ) {
+    tail[nu] = tail[nu + 1] + fWeights[nu];
+  }
+  for ( std::size_t nu = 0; nu < fCounts.size(); ++nu ) {
+    file << nu << "\t" << fCounts[nu] << "\t"
+         << fWeights[nu] / fSumW << "\t"
+         << tail[nu] / fSumW << "\n";
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ClusterSizeAccumulator::WriteSums(const G4String& fileName,
+                                       const G4String& header) const
+{
+  std::ofstream file(fileName);
+  if ( ! file ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open " << fileName << " for writing.";
+    G4Exception("ClusterSizeAccumulator::WriteSums()",
+      "MyCode0009", JustWarning, msg);
+    return;
+  }
+
+  // 17 significant digits restore the doubles exactly
+  file << std::setprecision(17) << header
+       << "# Ionisation cluster-size sums: events, sum w, w^2, w nu, w nu^2,"
+       << " w^2 nu, w^2 nu^2, estimated events\n"
+       << fNofEvents << "\t" << fSumW << "\t" << fSumW2 << "\t"
+       << fSum << "\t" << fSum2 << "\t" << fSumW2Nu << "\t" << fSumW2Nu2 << "\t"
+       << fNofEstimatedEvents << "\n"
+       << "# ClusterSize\tEvents\tWeights\n";
+  for ( std::size_t nu = 0; nu < fCounts.size(); ++nu ) {
+    file << nu << "\t" << fCounts[nu] << "\t" << fWeights[nu] << "\n";
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ClusterSizeAccumulator::ReadSums(const G4String& fileName)
+{
+  Reset();
+
+  std::ifstream file(fileName);
+  if ( ! file ) return false;
+
+  // Skip the comment lines, the sums are followed by one line per nu
+  auto nextLine = [&file](std::istringstream& line) {
+    std::string text;
+    while ( std::getline(file, text) ) {
+      if ( text.empty() || text[0] == '#' ) continue;
+      line.clear();
+      line.str(text);
+      return true;
+    }
+    return false;
+  };
+
+  std::istringstream line;
+  if ( ! nextLine(line) ) return false;
+  line >> fNofEvents >> fSumW >> fSumW2 >> fSum >> fSum2 >> fSumW2Nu >> fSumW2Nu2;
+  if ( line.fail() ) return false;
+  // absent in the sums of earlier versions
+  if ( ! ( line >> fNofEstimatedEvents ) ) fNofEstimatedEvents = 0;
+
+  while ( nextLine(line) ) {
+    std::size_t nu = 0;
+    G4long count = 0;
+    G4double weight = 0.;
+    line >> nu >> count >> weight;
+    if ( line.fail() || nu != fCounts.size() ) return false;
+    fCounts.push_back(count);
+    fWeights.push_back(weight);
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
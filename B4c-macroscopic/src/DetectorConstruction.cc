@@ -28,13 +28,18 @@
 /// \brief Implementation of the B4c::DetectorConstruction class
 
 #include "DetectorConstruction.hh"
+#include "DetectorMessenger.hh"
 #include "CalorimeterSD.hh"
 #include "G4Material.hh"
 #include "G4NistManager.hh"
 
 #include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
 #include "G4PVPlacement.hh"
 #include "G4PVReplica.hh"
+#include "G4Region.hh"
+#include "G4ProductionCuts.hh"
+#include "G4UserLimits.hh"
 #include "G4GlobalMagFieldMessenger.hh"
 #include "G4AutoDelete.hh"
 
@@ -45,11 +50,14 @@
 
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
 
 #include "G4Tubs.hh"
 #include "G4Sphere.hh"
 #include "G4Box.hh"
 
+#include <algorithm>
+
 
 namespace B4c
 {
@@ -62,13 +70,61 @@ G4GlobalMagFieldMessenger* DetectorConstruction::fMagFieldMessenger = nullptr;
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 DetectorConstruction::DetectorConstruction()
+ : fRegionMargin(1 * um),
+   fRegionCut(0.1 * nm)
 {
+  fMessenger = new DetectorMessenger(this);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 DetectorConstruction::~DetectorConstruction()
 {
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetRegionMargin(G4double margin)
+{
+  fRegionMargin = margin;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetRegionCut(G4double cut)
+{
+  fRegionCut = cut;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetVerboseLevel(G4int level)
+{
+  fVerboseLevel = level;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetMaxStep(const G4String& volume, G4double maxStep)
+{
+  fVolumeLimits[volume].fMaxStep = maxStep;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetMaxTrackLength(const G4String& volume,
+                                             G4double maxTrackLength)
+{
+  fVolumeLimits[volume].fMaxTrackLength = maxTrackLength;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetMinKineticEnergy(const G4String& volume,
+                                               G4double minKineticEnergy)
+{
+  fVolumeLimits[volume].fMinKineticEnergy = minKineticEnergy;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -92,8 +148,10 @@ void DetectorConstruction::DefineMaterials()
   nistManager->FindOrBuildMaterial("G4_LITHIUM_FLUORIDE");
   nistManager->FindOrBuildMaterial("G4_AIR");
 
-  // Print materials
-  G4cout << *(G4Material::GetMaterialTable()) << G4endl;
+  // Print materials (/microyz/det/verbose 1)
+  if ( fVerboseLevel > 0 ) {
+    G4cout << *(G4Material::GetMaterialTable()) << G4endl;
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -131,6 +189,7 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
   G4double phan_z = gap/2;
 
   // Be aware that placement moves with mother volume
+  // (SD_z is relative to the phantom, the SD is placed in the region envelope)
   G4double SD_Radius = worldRadius;
   G4double SD_Height = 1 * um;
   [[maybe_unused]] const G4double e = -phanHeight/2 + SD_Height/2; // entrance
@@ -226,17 +285,71 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
 
 
 
+  //
+  // Nanodosimetry region
+  //
+  // Water slab of the phantom around the SD, extended by the region margin
+  // (/microyz/det/regionMargin) along z as far as the phantom allows.
+  // Geant4-DNA models are activated in this region by PhysicsList
+  // (/microyz/phys/dnaRegion), condensed-history physics is used elsewhere.
+  G4double env_zmin = std::max(-phanHeight/2, SD_z - SD_Height/2 - fRegionMargin);
+  G4double env_zmax = std::min( phanHeight/2, SD_z + SD_Height/2 + fRegionMargin);
+  G4double env_z = (env_zmin + env_zmax)/2;
+
+  auto envelopeS
+	= new G4Tubs("NanodosimetryEnvelope",		// its name
+                 0,             			// its inner radius
+                 phanRadius,          			// its radius
+                 (env_zmax - env_zmin)/2,		// its half height
+                 0.*deg,                		// its start angle
+                 360.*deg);             		// is total angle
+
+  auto envelopeLV
+	= new G4LogicalVolume(
+			envelopeS,		// its solid
+			phanMaterial,		// its material
+			"NanodosimetryEnvelope");	// its name
+
+  new G4PVPlacement(
+		0, 								// its rotation
+		G4ThreeVector(0, 0, env_z),					// its placement
+		envelopeLV,							// its logical volume
+		"NanodosimetryEnvelope",					// its name
+		phanLV,								// its mother volume
+		false,								// no boolean operation
+		0,								// copy number
+		fCheckOverlaps);						// checking overlaps
+
+  auto nanodosimetryRegion = new G4Region("Nanodosimetry");
+  envelopeLV->SetRegion(nanodosimetryRegion);
+  nanodosimetryRegion->AddRootLogicalVolume(envelopeLV);
+
+  // Fine production cut only where we score, the world keeps /run/setCut
+  auto regionCuts = new G4ProductionCuts();
+  regionCuts->SetProductionCut(fRegionCut);
+  nanodosimetryRegion->SetProductionCuts(regionCuts);
+
+  G4cout << "Nanodosimetry region: z from " << G4BestUnit(env_zmin, "Length")
+         << " to " << G4BestUnit(env_zmax, "Length")
+         << " in the phantom, cut " << G4BestUnit(fRegionCut, "Length")
+         << G4endl;
+
   new G4PVPlacement(
 		0, 								// its rotation
-		G4ThreeVector(0, 0, SD_z),					// its placement
+		G4ThreeVector(0, 0, SD_z - env_z),				// its placement
 		SensitiveDetectorLV,						// its logical volume
 		"SensitiveDetector",						// its name
-		phanLV,								// its mother volume
+		envelopeLV,							// its mother volume
 		false,								// no boolean operation
 		0,								// copy number
 		fCheckOverlaps);						// checking overlaps
 
 
+  //
+  // User limits (/microyz/limits/ commands)
+  //
+  ApplyUserLimits();
+
   //
   // Always return the physical World
   //
@@ -245,6 +358,41 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void DetectorConstruction::ApplyUserLimits()
+{
+  // The limits only act on the particles with G4StepLimiter and
+  // G4UserSpecialCuts processes (electrons, see PhysicsList), they are not
+  // propagated to the daughter volumes
+  for ( const auto& [volume, limits] : fVolumeLimits ) {
+    auto logicalVolume = G4LogicalVolumeStore::GetInstance()->GetVolume(volume, false);
+    if ( logicalVolume == nullptr ) {
+      G4ExceptionDescription msg;
+      msg << "Logical volume " << volume << " not found, user limits ignored.";
+      G4Exception("DetectorConstruction::ApplyUserLimits()",
+        "MyCode0011", JustWarning, msg);
+      continue;
+    }
+
+    logicalVolume->SetUserLimits(
+      new G4UserLimits(limits.fMaxStep, limits.fMaxTrackLength, DBL_MAX,
+                       limits.fMinKineticEnergy));
+
+    G4cout << "User limits of " << volume << ":";
+    if ( limits.fMaxStep < DBL_MAX ) {
+      G4cout << " max step " << G4BestUnit(limits.fMaxStep, "Length");
+    }
+    if ( limits.fMaxTrackLength < DBL_MAX ) {
+      G4cout << " max track length " << G4BestUnit(limits.fMaxTrackLength, "Length");
+    }
+    if ( limits.fMinKineticEnergy > 0. ) {
+      G4cout << " min kinetic energy " << G4BestUnit(limits.fMinKineticEnergy, "Energy");
+    }
+    G4cout << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void DetectorConstruction::ConstructSDandField()
 {
   // G4SDManager::GetSDMpointer()->SetVerboseLevel(1);
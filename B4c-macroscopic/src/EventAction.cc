@@ -30,10 +30,14 @@
 #include "EventAction.hh"
 #include "CalorimeterSD.hh"
 #include "CalorHit.hh"
+#include "RunData.hh"
+#include "SharedRunData.hh"
+#include "JobPartition.hh"
 
 #include "G4AnalysisManager.hh"
 #include "G4RunManager.hh"
 #include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
 #include "G4SDManager.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4UnitsTable.hh"
@@ -41,14 +45,15 @@
 #include "Randomize.hh"
 #include <iomanip>
 
-#include <fstream>
+#include <cstdio>
 
 namespace B4c
 {
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-EventAction::EventAction()
+EventAction::EventAction(B4::RunData* runData)
+ : fRunData(runData)
 {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -58,60 +63,68 @@ EventAction::~EventAction()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-CalorHitsCollection*
-EventAction::GetHitsCollection(G4int hcID,
-                                  const G4Event* event) const
+const CalorimeterSD* EventAction::GetCalorimeterSD()
 {
-  auto hitsCollection
-    = static_cast<CalorHitsCollection*>(
-        event->GetHCofThisEvent()->GetHC(hcID));
+  if ( fCalorimeterSD ) return fCalorimeterSD;
 
-  if ( ! hitsCollection ) {
+  // The SD of this thread, registered in ConstructSDandField()
+  fCalorimeterSD = static_cast<const CalorimeterSD*>(
+    G4SDManager::GetSDMpointer()->FindSensitiveDetector("SensitiveDetector"));
+
+  if ( ! fCalorimeterSD ) {
     G4ExceptionDescription msg;
-    msg << "Cannot access hitsCollection ID " << hcID;
-    G4Exception("EventAction::GetHitsCollection()",
+    msg << "Cannot access sensitive detector SensitiveDetector";
+    G4Exception("EventAction::GetCalorimeterSD()",
       "MyCode0003", FatalException, msg);
   }
 
-  return hitsCollection;
+  return fCalorimeterSD;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 
-void EventAction::BeginOfEventAction(const G4Event* event)
-{
-
-  // Clear txt file on first event
-  if (event->GetEventID() == 0) {
-      std::ofstream outFile("data.txt", std::ios::trunc);
-      outFile << "EventID;tEnergy(keV);IonYield\n";  // Write header
-      outFile.close();
-     }
-}
+void EventAction::BeginOfEventAction(const G4Event* /*event*/)
+{}
 
 void EventAction::EndOfEventAction(const G4Event* event)
 {
-  // Get hits collection ID (only once)
-  if ( fSensitiveDetectorHCID == -1 ) {
-    fSensitiveDetectorHCID = G4SDManager::GetSDMpointer()->GetCollectionID("SensitiveDetectorHitsCollection");
-  }
+  // The event tracked after the phase space ran out has no primary vertex
+  // (the run is aborted in PrimaryGeneratorAction::GeneratePrimaries()),
+  // it is not an event of the source and is not scored
+  if ( event->GetNumberOfPrimaryVertex() == 0 ) return;
 
-  // Get hits collection for the SensitiveDetector
-  auto SensitiveDetectorHC = GetHitsCollection(fSensitiveDetectorHCID, event);
+  // Get hits of this event for the SensitiveDetector
+  const auto& hitStore = GetCalorimeterSD()->GetHitStore();
 
-  // Get hit with total values (since we have only one SensitiveDetector, we use index 0)
-  auto SensitiveDetectorHit = (*SensitiveDetectorHC)[0];
+  // Get hit with total values (since we have only one SensitiveDetector, we use layer 0)
+  auto SensitiveDetectorHit = &hitStore.GetCellHit(0);
   // if multipe entries use
-  //auto SensitiveDetectorHit = (*SensitiveDetectorHC)[SensitiveDetectorHC->entries()-1];
+  //auto SensitiveDetectorHit = &hitStore.GetTotalHit();
 
 
 
   // Print per event (modulo n)
   //
   auto eventID = event->GetEventID();
+  auto& sharedRunData = fRunData->GetShared();
+
+  // Event weight of a biased source (1 otherwise), carried by the primary
+  // vertex; it applies to all events, also those without energy deposit
+  G4double weight = event->GetPrimaryVertex()->GetWeight();
+
+  // Values of the event, estimated from the track weighted sums when the
+  // track weights differ from the event weight (splitting, roulette)
+  G4double edep = 0.;
+  G4double trackLength = 0.;
+  G4double ionYield = 0.;
+  G4bool exact
+    = SensitiveDetectorHit->GetEventValues(weight, edep, trackLength, ionYield);
+
+  auto& progressReporter = sharedRunData.GetProgressReporter();
   auto printModulo = G4RunManager::GetRunManager()->GetPrintProgress();
-  if ( ( printModulo > 0 ) && ( eventID % printModulo == 0 ) ) {
+  if ( ( progressReporter.GetVerboseLevel() > 1 )
+       || ( ( printModulo > 0 ) && ( eventID % printModulo == 0 ) ) ) {
     G4cout << "---> End of event: " << eventID << G4endl;
 
   G4cout << "   SensitiveDetector: total energy: "
@@ -128,31 +141,51 @@ void EventAction::EndOfEventAction(const G4Event* event)
   auto analysisManager = G4AnalysisManager::Instance();
 
   // Fill histograms for SensitiveDetector
-  analysisManager->FillH1(0, SensitiveDetectorHit->GetEdep());
-  analysisManager->FillH1(1, SensitiveDetectorHit->GetTrackLength());
+  analysisManager->FillH1(0, edep, weight);
+  analysisManager->FillH1(1, trackLength, weight);
 
   // Fill ntuple for SensitiveDetector
-  analysisManager->FillNtupleDColumn(0, SensitiveDetectorHit->GetEdep());
-  analysisManager->FillNtupleDColumn(1, SensitiveDetectorHit->GetTrackLength());
+  analysisManager->FillNtupleDColumn(0, edep);
+  analysisManager->FillNtupleDColumn(1, trackLength);
+  analysisManager->FillNtupleDColumn(2, weight);
   analysisManager->AddNtupleRow();
 
 
-  // Fill in txt file for SensitiveDetector
-  // Open file in append mode
-  std::ofstream outFile("data.txt", std::ios::app);
+  // Add the cluster size of this event to the distribution of this thread
+  // and to the live distribution of all threads
+  fRunData->GetClusterSizes().Fill(ionYield, weight, ! exact);
+  sharedRunData.GetLiveClusterSizes().Fill(ionYield, weight);
 
-  if (outFile.is_open()) {
-      outFile << eventID << ";"  // Event number
-              << SensitiveDetectorHit->GetEdep() / CLHEP::keV << ";"  // Convert energy to eV
-              << SensitiveDetectorHit->GetIonYield() << "\n";  // Cluster size
-  } else {
-      G4cerr << "Error opening file for writing!" << G4endl;
+  // Convergence based early stop: finish the current event and stop the
+  // event loop of this thread once the target precision is reached
+  auto& convergenceMonitor = sharedRunData.GetConvergenceMonitor();
+  if ( convergenceMonitor.IsEnabled() ) {
+    convergenceMonitor.AddEvent(edep, ionYield, weight);
+    if ( convergenceMonitor.IsConverged() ) {
+      G4RunManager::GetRunManager()->AbortRun(true);
+    }
   }
 
-  outFile.close();  // Close the file after writing
-
-
+  // Fill in txt file for SensitiveDetector (unless /microyz/output/eventRecords false)
+  // The record is formatted once and copied into the buffered output of this
+  // thread, the shards are merged into data.txt at the end of the run
+  // (events are numbered by their global ID, /microyz/output/fullPrecision
+  // writes the energies and weights with all their digits)
+  if ( fRunData->GetEventOutput().IsOpen() ) {
+    char record[128];
+    auto size = std::snprintf(record, sizeof(record),
+                              fRunData->IsFullPrecision()
+                                ? "%ld;%.17g;%.17g;%.17g\n"
+                                : "%ld;%g;%g;%g\n",
+                              B4::JobPartition::GetGlobalEventID(eventID),  // Event number
+                              edep / CLHEP::keV,                            // Convert energy to keV
+                              ionYield,                                     // Cluster size
+                              weight);                                      // Event weight
+    fRunData->GetEventOutput().Write(record, size);
+  }
 
+  // Count the event for the progress report
+  progressReporter.EventDone();
 }
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
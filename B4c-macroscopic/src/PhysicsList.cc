@@ -35,6 +35,7 @@
 
 #include "PhysicsList.hh"
 #include "PhysicsListMessenger.hh"
+#include "PhysicsTableCache.hh"
 
 #include "G4EmDNAPhysics.hh"
 #include "G4EmDNAPhysics_option1.hh"
@@ -45,11 +46,25 @@
 #include "G4EmDNAPhysics_option6.hh"
 #include "G4EmDNAPhysics_option7.hh"
 #include "G4EmDNAPhysics_option8.hh"
+#include "G4EmDNAPhysicsActivator.hh"
 
 #include "G4EmLivermorePhysics.hh"
 #include "G4EmPenelopePhysics.hh"
 #include "G4EmStandardPhysics_option4.hh"
 
+#include "G4EmParameters.hh"
+#include "G4VEmProcess.hh"
+#include "G4VEnergyLossProcess.hh"
+#include "G4VEmModel.hh"
+#include "G4ProcessManager.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4Material.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+#include "G4Threading.hh"
+
 #include "G4UserSpecialCuts.hh"
 #include "G4StepLimiter.hh"
 
@@ -69,6 +84,7 @@
 
 // particles
 
+#include "G4Electron.hh"
 #include "G4Proton.hh"
 #include "G4BosonConstructor.hh"
 #include "G4LeptonConstructor.hh"
@@ -82,17 +98,25 @@
 //  configurate EM models for particles/processes/regions
 #include "G4EmConfigurator.hh"
 
+#include <iomanip>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 PhysicsList::PhysicsList() : G4VModularPhysicsList(),
-  fEmPhysicsList(0), fMessenger(0)
+  fEmPhysicsList(0), fDnaActivator(0), fMessenger(0), fTableCache(0)
 {
   fMessenger = new PhysicsListMessenger(this);
 
+  // physics table cache and startup times (/microyz/phys/tableCache)
+  fTableCache = new B4::PhysicsTableCache(this);
+
   SetVerboseLevel(1);
 
   // EM physics
   fEmPhysicsList = new G4EmDNAPhysics_option4();
+
+  // Geant4-DNA models in the region Nanodosimetry (/microyz/phys/dnaRegion)
+  fDnaActivator = new G4EmDNAPhysicsActivator();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -101,6 +125,7 @@ PhysicsList::~PhysicsList()
 {
   delete fMessenger;
   delete fEmPhysicsList;
+  delete fDnaActivator;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -131,6 +156,8 @@ void PhysicsList::ConstructParticle()
     genericIonsManager->GetIon("alpha+");
     genericIonsManager->GetIon("helium");
     genericIonsManager->GetIon("hydrogen");
+
+    fDnaActivator->ConstructParticle();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -141,10 +168,39 @@ void PhysicsList::ConstructProcess()
   //
   AddTransportation();
 
+  // Geant4-DNA models only inside the region around the sensitive detectors
+  // (created by DetectorConstruction), the condensed-history models of the
+  // selected list everywhere else
+  //
+  G4bool dnaRegion = false;
+  if (fDnaRegionOption != "none") {
+    if (fEmName.empty() || fEmName.find("dna") == 0) {
+      G4cout << "PhysicsList::ConstructProcess: Geant4-DNA region ignored, <"
+             << (fEmName.empty() ? G4String("dna_opt4") : fEmName)
+             << "> uses Geant4-DNA everywhere" << G4endl;
+    } else {
+      G4EmParameters::Instance()->AddDNA("Nanodosimetry", fDnaRegionOption);
+      dnaRegion = true;
+    }
+  }
+
   // electromagnetic physics list
   //
   fEmPhysicsList->ConstructProcess();
 
+  // the activator adds the Geant4-DNA processes and models of the region
+  // on top of the processes of the list, AddDNA() alone does nothing
+  //
+  if (dnaRegion) fDnaActivator->ConstructProcess();
+
+  // the selected lists are part of the key of the cached physics tables
+  //
+  if (G4Threading::IsMasterThread()) {
+    fTableCache->SetConfiguration(
+      (fEmName.empty() ? G4String("dna_opt4") : fEmName)
+      + " dnaRegion " + fDnaRegionOption);
+  }
+
 
   // user-defined hadronic processes
 
@@ -297,6 +353,26 @@ void PhysicsList::AddPhysicsList(const G4String& name)
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void PhysicsList::SetDnaRegion(const G4String& option)
+{
+  if (verboseLevel>-1) {
+    G4cout << "PhysicsList::SetDnaRegion: <" << option << ">" << G4endl;
+  }
+  fDnaRegionOption = option;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsList::SetTableCache(const G4String& directory)
+{
+  if (verboseLevel>-1) {
+    G4cout << "PhysicsList::SetTableCache: <" << directory << ">" << G4endl;
+  }
+  fTableCache->SetDirectory(directory);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void PhysicsList::AddTrackingCut()
 {
 
@@ -336,4 +412,60 @@ void PhysicsList::AddMaxStepSize()
     }
   }
 }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsList::CheckDnaRegion() const
+{
+  if (fDnaRegionOption == "none") return;
+
+  G4Region* region =
+    G4RegionStore::GetInstance()->GetRegion("Nanodosimetry", false);
+  if (region == nullptr) return;
+
+  // models selected in the couples of the region at 10 keV, the energy
+  // range where both electrons and protons are within Geant4-DNA
+  const G4double energy = 10.*keV;
+  auto cutsTable = G4ProductionCutsTable::GetProductionCutsTable();
+  const G4ParticleDefinition* particles[] =
+    { G4Electron::Definition(), G4Proton::Definition() };
+  G4int nofDnaModels = 0;
+
+  G4cout << "PhysicsList::CheckDnaRegion: models in region Nanodosimetry at "
+         << G4BestUnit(energy, "Energy") << G4endl;
+  for (auto particle : particles) {
+    G4ProcessVector* processes = particle->GetProcessManager()->GetProcessList();
+    for (std::size_t i = 0; i < processes->size(); ++i) {
+      auto emProcess = dynamic_cast<G4VEmProcess*>((*processes)[i]);
+      auto lossProcess = dynamic_cast<G4VEnergyLossProcess*>((*processes)[i]);
+      if (emProcess == nullptr && lossProcess == nullptr) continue;
+
+      auto material = region->GetMaterialIterator();
+      for (std::size_t j = 0; j < region->GetNumberOfMaterials(); ++j, ++material) {
+        G4int index = cutsTable->GetCoupleIndex(*material, region->GetProductionCuts());
+        if (index < 0) continue;
+        std::size_t coupleIndex = index;
+        const G4VEmModel* model = (emProcess != nullptr)
+          ? emProcess->SelectModelForMaterial(energy, coupleIndex)
+          : lossProcess->SelectModelForMaterial(energy, coupleIndex);
+        if (model == nullptr) continue;
+
+        G4cout << "  " << std::setw(10) << particle->GetParticleName()
+               << std::setw(24) << (*processes)[i]->GetProcessName()
+               << std::setw(12) << (*material)->GetName()
+               << "  " << model->GetName() << G4endl;
+        if (model->GetName().find("DNA") != std::string::npos) ++nofDnaModels;
+      }
+    }
+  }
+
+  if (nofDnaModels == 0) {
+    G4ExceptionDescription msg;
+    msg << "No Geant4-DNA model is attached to the region Nanodosimetry "
+        << "(/microyz/phys/dnaRegion " << fDnaRegionOption << ").";
+    G4Exception("PhysicsList::CheckDnaRegion()",
+      "MyCode0019", JustWarning, msg);
+  }
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
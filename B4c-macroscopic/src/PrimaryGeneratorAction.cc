@@ -28,6 +28,8 @@
 /// \brief Implementation of the B4::PrimaryGeneratorAction class
 
 #include "PrimaryGeneratorAction.hh"
+#include "PrimaryGeneratorMessenger.hh"
+#include "JobPartition.hh"
 #include "G4RunManager.hh"
 #include "G4LogicalVolumeStore.hh"
 #include "G4LogicalVolume.hh"
@@ -54,6 +56,7 @@ namespace B4
 PrimaryGeneratorAction::PrimaryGeneratorAction()
 {
   fParticleGun = new G4GeneralParticleSource();
+  fMessenger = new PrimaryGeneratorMessenger(&fPhaseSpaceReader);
 
   // Set default particle as  proton
   auto particleDef = G4ParticleTable::GetParticleTable()->FindParticle("proton");
@@ -109,6 +112,7 @@ PrimaryGeneratorAction::PrimaryGeneratorAction()
 
 PrimaryGeneratorAction::~PrimaryGeneratorAction()
 {
+  delete fMessenger;
   delete fParticleGun;
 }
 
@@ -118,6 +122,18 @@ void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
   // This function is called at the beginning of event
 
+  // Seed the event from its global event ID in a partitioned run
+  JobPartition::SeedEvent(anEvent->GetEventID());
+
+  // Replay the phase space, stop the run once it is exhausted (the current
+  // event is then tracked without primaries and not scored by EventAction)
+  if ( fPhaseSpaceReader.IsEnabled() ) {
+    if ( ! fPhaseSpaceReader.GeneratePrimaries(anEvent) ) {
+      G4RunManager::GetRunManager()->AbortRun(true);
+    }
+    return;
+  }
+
   // Generate particle and assign it to the event
   fParticleGun->GeneratePrimaryVertex(anEvent);
 }
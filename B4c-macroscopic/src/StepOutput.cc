@@ -0,0 +1,166 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StepOutput.cc
+/// \brief Implementation of the B4::StepOutput class
+
+#include "StepOutput.hh"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace B4
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepOutput::SetFormat(Format format)
+{
+  fFormat = format;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepOutput::SetDeltaEventID(G4bool value)
+{
+  fDeltaEventID = value;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String StepOutput::FileName(const G4String& baseName) const
+{
+  return baseName + ( fFormat == Format::kBinary ? ".bin" : ".txt" );
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepOutput::Open(const G4String& baseName)
+{
+  fShard.Open(FileName(baseName));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepOutput::Close()
+{
+  fShard.Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepOutput::Merge(const G4String& baseName) const
+{
+  if ( fFormat == Format::kBinary ) {
+    MergeBinary(FileName(baseName));
+  }
+  else {
+    OutputShard::MergeTextShards(FileName(baseName),
+                                 "EventID;z(nm);x(nm);y(nm);Energy(keV)\n");
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepOutput::MergeBinary(const G4String& fileName) const
+{
+  using StepRecordFormat::kRecordSize;
+
+  auto shards = OutputShard::TakeShards(fileName);
+
+  std::ofstream outFile(fileName, std::ios::trunc | std::ios::binary);
+  if ( ! outFile.is_open() ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open " << fileName << " for merging";
+    G4Exception("StepOutput::MergeBinary()", "MyCode0006", JustWarning, msg);
+    return;
+  }
+  auto header = StepRecordFormat::EncodeHeader(
+    fDeltaEventID ? StepRecordFormat::kDeltaEventID : 0u);
+  outFile.write(header.data(), header.size());
+
+  // One read cursor per shard, positioned on its next record
+  struct Cursor {
+    std::ifstream in;
+    char record[kRecordSize];
+    std::int64_t eventID = 0;
+  };
+  auto next = [](Cursor& cursor) {
+    if ( ! cursor.in.read(cursor.record, kRecordSize) ) return false;
+    std::memcpy(&cursor.eventID, cursor.record, sizeof(cursor.eventID));
+    return true;
+  };
+
+  // k-way merge on (event ID, shard index), as for the text shards
+  using Entry = std::pair<std::int64_t, std::size_t>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+  std::vector<std::unique_ptr<Cursor>> cursors;
+  for ( const auto& shard : shards ) {
+    auto cursor = std::make_unique<Cursor>();
+    cursor->in.open(shard, std::ios::binary);
+    if ( next(*cursor) ) queue.emplace(cursor->eventID, cursors.size());
+    cursors.push_back(std::move(cursor));
+  }
+
+  std::int64_t lastEventID = 0;
+  while ( ! queue.empty() ) {
+    auto index = queue.top().second;
+    queue.pop();
+
+    auto& cursor = *cursors[index];
+    auto eventID = cursor.eventID;
+    G4bool more = false;
+    do {
+      // Shards hold absolute event IDs, the delta encoding is done here
+      if ( fDeltaEventID ) {
+        std::int64_t delta = eventID - lastEventID;
+        std::memcpy(cursor.record, &delta, sizeof(delta));
+      }
+      lastEventID = eventID;
+      outFile.write(cursor.record, kRecordSize);
+      more = next(cursor);
+    } while ( more && cursor.eventID == eventID );
+
+    if ( more ) queue.emplace(cursor.eventID, index);
+  }
+
+  // Remove the merged shards
+  cursors.clear();
+  for ( const auto& shard : shards ) {
+    std::remove(shard.c_str());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
@@ -0,0 +1,133 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file stepbin2csv.cc
+/// \brief Converts the binary per-step output to the ';' separated text format
+
+// Usage: stepbin2csv braggcurve_data.bin [braggcurve_data.txt]
+//
+// The output is identical to the one written with
+// /microyz/output/stepFormat text, up to the float32 precision of the
+// binary columns.
+
+#include "StepRecordFormat.hh"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+  if ( argc < 2 || argc > 3 ) {
+    std::cerr << " Usage: stepbin2csv input.bin [output.txt]" << std::endl;
+    return 1;
+  }
+
+  std::ifstream in(argv[1], std::ios::binary);
+  if ( ! in.is_open() ) {
+    std::cerr << "Cannot open " << argv[1] << std::endl;
+    return 1;
+  }
+
+  B4::StepRecordFormat::Header header;
+  if ( ! B4::StepRecordFormat::DecodeHeader(in, header) ) {
+    std::cerr << argv[1] << " is not a per-step record stream"
+              << " (or was written with another byte order)" << std::endl;
+    return 1;
+  }
+
+  // Column offsets inside the record
+  std::vector<std::size_t> offsets;
+  std::size_t recordSize = 0;
+  for ( auto type : header.types ) {
+    auto size = B4::StepRecordFormat::ColumnSize(type);
+    if ( size == 0 ) {
+      std::cerr << "Unknown column type '" << type << "'" << std::endl;
+      return 1;
+    }
+    offsets.push_back(recordSize);
+    recordSize += size;
+  }
+  if ( recordSize != header.recordSize ) {
+    std::cerr << "Inconsistent record size in header" << std::endl;
+    return 1;
+  }
+
+  auto out = ( argc == 3 ) ? std::fopen(argv[2], "w") : stdout;
+  if ( ! out ) {
+    std::cerr << "Cannot open " << argv[2] << std::endl;
+    return 1;
+  }
+
+  // Header line
+  for ( std::size_t i = 0; i < header.names.size(); ++i ) {
+    std::fprintf(out, "%s%s", i ? ";" : "", header.names[i].c_str());
+  }
+  std::fputc('\n', out);
+
+  // Records, the first integer column is the (possibly delta-encoded) event
+  // ID, int32 in version 1 files and int64 since version 2
+  auto delta = ( header.flags & B4::StepRecordFormat::kDeltaEventID ) != 0;
+  std::int64_t eventID = 0;
+  std::vector<char> record(recordSize);
+  while ( in.read(record.data(), recordSize) ) {
+    for ( std::size_t i = 0; i < offsets.size(); ++i ) {
+      const char* separator = i ? ";" : "";
+      if ( header.types[i] == 'i' || header.types[i] == 'l' ) {
+        std::int64_t value = 0;
+        if ( header.types[i] == 'l' ) {
+          std::memcpy(&value, record.data() + offsets[i], sizeof(value));
+        }
+        else {
+          std::int32_t value32 = 0;
+          std::memcpy(&value32, record.data() + offsets[i], sizeof(value32));
+          value = value32;
+        }
+        if ( i == 0 ) {
+          eventID = delta ? eventID + value : value;
+          std::fprintf(out, "%s%lld", separator, static_cast<long long>(eventID));
+        }
+        else {
+          std::fprintf(out, "%s%lld", separator, static_cast<long long>(value));
+        }
+      }
+      else {
+        float value = 0.f;
+        std::memcpy(&value, record.data() + offsets[i], sizeof(value));
+        std::fprintf(out, "%s%g", separator, value);
+      }
+    }
+    std::fputc('\n', out);
+  }
+
+  if ( in.gcount() != 0 ) {
+    std::cerr << "Warning: truncated last record ignored" << std::endl;
+  }
+  if ( out != stdout ) std::fclose(out);
+  return 0;
+}
@@ -31,8 +31,13 @@
 
 #include "DetectorConstruction.hh"
 #include "ActionInitialization.hh"
+#include "JobPartition.hh"
 
 #include "G4RunManagerFactory.hh"
+#ifdef G4MULTITHREADED
+#include "G4MTRunManager.hh"
+#include "G4TaskRunManager.hh"
+#endif
 #include "G4SteppingVerbose.hh"
 #include "G4UIcommand.hh"
 #include "G4UImanager.hh"
@@ -42,6 +47,8 @@
 #include "QGSP_BIC.hh"
 #include "Randomize.hh"
 
+#include <string>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 namespace {
@@ -49,8 +56,77 @@ namespace {
     G4cerr << " Usage: " << G4endl;
     G4cerr << " exampleB4c [-m macro ] [-u UIsession] [-t nThreads] [-vDefault]"
            << G4endl;
-    G4cerr << "   note: -t option is available only for multi-threaded mode."
+    G4cerr << "            [-r serial|mt|tasking|tbb|default] [-e eventModulo]"
+           << G4endl;
+    G4cerr << "            [-s seedOnce] [-g grainsize] [-p pinAffinity] [--job i/N]"
+           << G4endl;
+    G4cerr << "   note: -t, -e, -s, -g and -p options are available only for"
+           << " multi-threaded mode." << G4endl;
+    G4cerr << "   -r selects the run manager (default: G4RUN_MANAGER_TYPE or"
+           << " the build default)," << G4endl;
+    G4cerr << "   -e the number of events a worker pulls at a time (0 = automatic),"
+           << G4endl;
+    G4cerr << "   -s seeds per event (0), per pulled batch (1) or per run (2),"
+           << G4endl;
+    G4cerr << "      used only with /microyz/random/perEventSeeds false,"
+           << G4endl;
+    G4cerr << "   -g the number of tasks a run is split into (tasking, 0 = automatic),"
            << G4endl;
+    G4cerr << "   -p pins the threads to cores (see /run/pinAffinity)." << G4endl;
+    G4cerr << "   /run/numberOfThreads, /run/eventModulo (modulo, seedOnce) and /run/pinAffinity"
+           << " change them in macros." << G4endl;
+    G4cerr << "   --job i/N (or -j) runs job i (0 to N-1) of a run partitioned into N jobs,"
+           << G4endl;
+    G4cerr << "   see /microyz/job/beamOn; mergeJobs combines their outputs." << G4endl;
+  }
+
+  // Run manager type of the -r option
+  G4bool GetRunManagerType(const G4String& name, G4RunManagerType& type)
+  {
+    if      ( name == "default" ) type = G4RunManagerType::Default;
+    else if ( name == "serial" )  type = G4RunManagerType::Serial;
+    else if ( name == "mt" )      type = G4RunManagerType::MT;
+    else if ( name == "tasking" ) type = G4RunManagerType::Tasking;
+    else if ( name == "tbb" )     type = G4RunManagerType::TBB;
+    else return false;
+    return true;
+  }
+
+  // Startup report of the run manager configuration
+  void PrintRunManagerConfiguration(G4RunManager* runManager)
+  {
+    G4String type = "serial (G4RunManager)";
+    G4String eventModulo = "-";
+    G4String seedOnce = "-";
+    G4String grainsize = "-";
+    G4String pinAffinity = "-";
+#ifdef G4MULTITHREADED
+    if ( auto mtRunManager = dynamic_cast<G4MTRunManager*>(runManager) ) {
+      type = "multi-threaded (G4MTRunManager)";
+      if ( auto taskRunManager = dynamic_cast<G4TaskRunManager*>(runManager) ) {
+        type = "tasking (G4TaskRunManager)";
+        auto value = taskRunManager->GetGrainsize();
+        grainsize = ( value > 0 ) ? std::to_string(value) : G4String("automatic");
+      }
+      auto modulo = mtRunManager->GetEventModulo();
+      eventModulo = ( modulo > 0 ) ? std::to_string(modulo) : G4String("automatic");
+      const char* seedModes[] = { "per event", "per batch", "per run" };
+      auto seedMode = G4MTRunManager::SeedOncePerCommunication();
+      seedOnce = ( seedMode >= 0 && seedMode <= 2 ) ? seedModes[seedMode] : "-";
+      auto pin = mtRunManager->GetPinAffinity();
+      pinAffinity = ( pin != 0 ) ? std::to_string(pin) : G4String("off");
+    }
+#endif
+
+    G4cout << G4endl
+           << "--------------------Run manager--------------------" << G4endl
+           << " Type         : " << type << G4endl
+           << " Threads      : " << runManager->GetNumberOfThreads() << G4endl
+           << " Event modulo : " << eventModulo << G4endl
+           << " Seeds        : " << seedOnce << G4endl
+           << " Grainsize    : " << grainsize << G4endl
+           << " Pin affinity : " << pinAffinity << G4endl
+           << "---------------------------------------------------" << G4endl;
   }
 }
 
@@ -60,7 +136,7 @@ int main(int argc,char** argv)
 {
   // Evaluate arguments
   //
-  if ( argc > 7 ) {
+  if ( argc > 20 ) {
     PrintUsage();
     return 1;
   }
@@ -68,16 +144,49 @@ int main(int argc,char** argv)
   G4String macro;
   G4String session;
   G4bool verboseBestUnits = true;
+  auto runManagerType = G4RunManagerType::Default;
 #ifdef G4MULTITHREADED
   G4int nThreads = 0;
+  G4int eventModulo = 0;
+  G4int seedOnce = -1;
+  G4int grainsize = 0;
+  G4int pinAffinity = 0;
 #endif
   for ( G4int i=1; i<argc; i=i+2 ) {
+    if ( G4String(argv[i]) != "-vDefault" && i+1 >= argc ) {
+      PrintUsage();
+      return 1;
+    }
     if      ( G4String(argv[i]) == "-m" ) macro = argv[i+1];
     else if ( G4String(argv[i]) == "-u" ) session = argv[i+1];
+    else if ( G4String(argv[i]) == "-j" || G4String(argv[i]) == "--job" ) {
+      if ( ! B4::JobPartition::Configure(argv[i+1]) ) {
+        PrintUsage();
+        return 1;
+      }
+    }
+    else if ( G4String(argv[i]) == "-r" ) {
+      if ( ! GetRunManagerType(argv[i+1], runManagerType) ) {
+        PrintUsage();
+        return 1;
+      }
+    }
 #ifdef G4MULTITHREADED
     else if ( G4String(argv[i]) == "-t" ) {
       nThreads = G4UIcommand::ConvertToInt(argv[i+1]);
     }
+    else if ( G4String(argv[i]) == "-e" ) {
+      eventModulo = G4UIcommand::ConvertToInt(argv[i+1]);
+    }
+    else if ( G4String(argv[i]) == "-s" ) {
+      seedOnce = G4UIcommand::ConvertToInt(argv[i+1]);
+    }
+    else if ( G4String(argv[i]) == "-g" ) {
+      grainsize = G4UIcommand::ConvertToInt(argv[i+1]);
+    }
+    else if ( G4String(argv[i]) == "-p" ) {
+      pinAffinity = G4UIcommand::ConvertToInt(argv[i+1]);
+    }
 #endif
     else if ( G4String(argv[i]) == "-vDefault" ) {
       verboseBestUnits = false;
@@ -105,15 +214,31 @@ int main(int argc,char** argv)
     G4SteppingVerbose::UseBestUnit(precision);
   }
 
-  // Construct the default run manager
+  // Construct the run manager (-r option, default run manager otherwise)
   //
   auto* runManager =
-    G4RunManagerFactory::CreateRunManager(G4RunManagerType::Default);
+    G4RunManagerFactory::CreateRunManager(runManagerType);
 #ifdef G4MULTITHREADED
   if ( nThreads > 0 ) {
     runManager->SetNumberOfThreads(nThreads);
   }
+
+  // Event dispatch of the worker threads
+  if ( auto mtRunManager = dynamic_cast<G4MTRunManager*>(runManager) ) {
+    if ( eventModulo > 0 ) mtRunManager->SetEventModulo(eventModulo);
+    if ( seedOnce >= 0 ) mtRunManager->SetSeedOncePerCommunication(seedOnce);
+    if ( pinAffinity != 0 ) mtRunManager->SetPinAffinity(pinAffinity);
+    if ( auto taskRunManager = dynamic_cast<G4TaskRunManager*>(runManager) ) {
+      if ( grainsize > 0 ) taskRunManager->SetGrainsize(grainsize);
+    }
+  }
 #endif
+  PrintRunManagerConfiguration(runManager);
+  if ( B4::JobPartition::IsEnabled() ) {
+    G4cout << "Job " << B4::JobPartition::GetIndex() << " of "
+           << B4::JobPartition::GetCount() << " (events seeded per global event ID)"
+           << G4endl;
+  }
 
   // Set mandatory initialization classes
   //
@@ -37,6 +37,9 @@
 #include "G4ThreeVector.hh"
 #include "G4Threading.hh"
 
+#include <algorithm>
+#include <cfloat>
+
 namespace B4c
 {
 
@@ -45,6 +48,12 @@ namespace B4c
 /// It defines data members to store the the energy deposit and track lengths
 /// of charged particles in a selected volume:
 /// - fEdep, fTrackLength
+/// together with the same sums weighted by the track weight, which differs
+/// from the event weight with splitting, Russian roulette or cross-section
+/// biasing:
+/// - fWeightedEdep, fWeightedTrackLength, fWeightedIonYield
+/// and the copy number of the nanoparticle it accounts for:
+/// - fCellID (-1 for the hit with the total over all nanoparticles)
 
 // Inheret Calorhit from G4VHit
 class CalorHit : public G4VHit
@@ -67,15 +76,33 @@ class CalorHit : public G4VHit
     void Print() override;		// Print method, implemented in .cc file
 
     // Data handling methods
-    void Add(G4double de, G4double dl, G4int dnIon);	// Declare Add method for  deposited energy, track length and number of ionizations
+    void Add(G4double de, G4double dl, G4int dnIon,
+             G4double weight = 1.);			// Declare Add method for  deposited energy, track length and number of ionizations of a track with given weight
     G4double GetEdep() const;				// Declare method to return stored energy deposit
     G4double GetTrackLength() const;			// Declare method to return stored track length
     G4int GetIonYield() const;				// Declare method to return stored ionization yield
+    G4double GetWeightedEdep() const;			// Declare method to return the track weighted energy deposit
+    G4double GetWeightedTrackLength() const;		// Declare method to return the track weighted track length
+    G4double GetWeightedIonYield() const;		// Declare method to return the track weighted ionization yield
+
+    // Values of the event with the given event weight, returns false if
+    // the track weights differ from it and the values are estimated (the
+    // cluster size is then in general not an integer)
+    G4bool GetEventValues(G4double eventWeight, G4double& edep,
+                          G4double& trackLength, G4double& ionYield) const;
+    void SetCellID(G4int cellID);			// Declare method to set the nanoparticle copy number
+    G4int GetCellID() const;				// Declare method to return the nanoparticle copy number
 
   private:
     G4double fEdep = 0.;        ///< Energy deposit in the sensitive volume
     G4double fTrackLength = 0.; ///< Track length in the  sensitive volume
     G4int fIonYield = 0.;	///< Ionization yield in the sensitive volume
+    G4double fWeightedEdep = 0.;        ///< Sum of track weight * energy deposit
+    G4double fWeightedTrackLength = 0.; ///< Sum of track weight * track length
+    G4double fWeightedIonYield = 0.;    ///< Sum of track weight * ionizations
+    G4double fMinWeight = DBL_MAX;      ///< Smallest track weight added
+    G4double fMaxWeight = 0.;           ///< Largest track weight added
+    G4int fCellID = -1;		///< Copy number of the sensitive volume, -1 for total
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -109,10 +136,15 @@ inline void CalorHit::operator delete(void *hit)
 }
 
 // Adds deposited energy and track length to the existing values
-inline void CalorHit::Add(G4double de, G4double dl, G4int dnIon) {
+inline void CalorHit::Add(G4double de, G4double dl, G4int dnIon, G4double weight) {
   fEdep += de;
   fTrackLength += dl;
   fIonYield += dnIon;
+  fWeightedEdep += weight * de;
+  fWeightedTrackLength += weight * dl;
+  fWeightedIonYield += weight * dnIon;
+  fMinWeight = std::min(fMinWeight, weight);
+  fMaxWeight = std::max(fMaxWeight, weight);
 }
 
 // Returns stored energy deposit in hit
@@ -130,6 +162,31 @@ inline G4int CalorHit::GetIonYield() const {
   return fIonYield;
 }
 
+// Returns the track weighted energy deposit in hit
+inline G4double CalorHit::GetWeightedEdep() const {
+  return fWeightedEdep;
+}
+
+// Returns the track weighted track length in hit
+inline G4double CalorHit::GetWeightedTrackLength() const {
+  return fWeightedTrackLength;
+}
+
+// Returns the track weighted ionization yield in hit
+inline G4double CalorHit::GetWeightedIonYield() const {
+  return fWeightedIonYield;
+}
+
+// Sets the copy number of the nanoparticle accounted by this hit
+inline void CalorHit::SetCellID(G4int cellID) {
+  fCellID = cellID;
+}
+
+// Returns the copy number of the nanoparticle accounted by this hit
+inline G4int CalorHit::GetCellID() const {
+  return fCellID;
+}
+
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -33,26 +33,42 @@
 #include "G4VSensitiveDetector.hh"
 
 #include "CalorHit.hh"
-
-#include <vector>
+#include "CalorHitStore.hh"
 
 class G4Step;
 class G4HCofThisEvent;
 
+namespace B4
+{
+class IonisationClassifier;
+class RunData;
+}
+
 namespace B4c
 {
 
 /// Calorimeter sensitive detector class
 ///
-/// In Initialize(), it creates one hit for each calorimeter layer and one more
-/// hit for accounting the total quantities in all layers.
+/// The hits of an event are accounted in the CalorHitStore of this thread,
+/// which keeps a hit for each cell touched in the event, taken from a reused
+/// pool, and one hit for the total quantities in all cells; Initialize()
+/// clears the hits touched in the previous event. EventAction reads the hits
+/// from GetHitStore().
 ///
 /// The values are accounted in hits in ProcessHits() function which is called
 /// by Geant4 kernel at each step.
+/// It is a staged filter: steps without energy deposit and length are
+/// rejected first, the secondaries are only classified when there are any.
+/// The number of steps per stage is counted in the RunData of the thread,
+/// handed over by RunAction at the start of each run (SetRunData()), and
+/// reported by RunAction at end of run.
 ///
-/// --> Excisitng hit adds up all energy depositions in a layer
-/// --> ProcessHits() runs at every step, updating the existing hit instead of making new ones
-/// --> An extra hit accounts for the total energy in ALL layers
+/// --> Cells are the nanoparticles of the grid, identified by their copy number
+/// --> A hits collection is only made in EndOfEvent() when it is asked for
+///     (/microyz/scoring/hitsCollection, or verbose level > 0); it holds
+///     copies of the total hit followed by the hits of the touched cells
+///     (/microyz/scoring/allCellsHitsCollection: the hits of all cells followed
+///     by the total hit, the per-event allocation of the former design)
 
 class CalorimeterSD : public G4VSensitiveDetector
 {
@@ -67,9 +83,25 @@ class CalorimeterSD : public G4VSensitiveDetector
     G4bool ProcessHits(G4Step* step, G4TouchableHistory* history) override;
     void   EndOfEvent(G4HCofThisEvent* hitCollection) override;
 
+    // Hits of the current event
+    const CalorHitStore& GetHitStore() const { return fHitStore; }
+
+    // Run data of this thread, set by RunAction at the start of each run
+    void SetRunData(B4::RunData* runData);
+
   private:
-    CalorHitsCollection* fHitsCollection = nullptr;
+    CalorHitStore fHitStore;
+    G4int fHitsCollectionID = -1;
     G4int fNofCells = 0;
+    B4::RunData* fRunData = nullptr;                                 // of this thread
+    const B4::IonisationClassifier* fIonisationClassifier = nullptr; // of this thread's RunData
+
+    // Steps passing the stages of ProcessHits() in this event,
+    // added to the run totals of RunData in EndOfEvent()
+    G4long fNofStepsProcessed = 0;  // all calls
+    G4long fNofStepsNoDeposit = 0;  // rejected, no energy deposit and no length
+    G4long fNofStepsClassified = 0; // with secondaries to classify
+    G4long fNofStepsRecorded = 0;   // added to the hits
 };
 
 }
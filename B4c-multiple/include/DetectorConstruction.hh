@@ -31,20 +31,45 @@
 #define B4cDetectorConstruction_h 1
 
 #include "G4VUserDetectorConstruction.hh"
+#include "G4ThreeVector.hh"
 #include "globals.hh"
 
+#include <map>
+
 class G4VPhysicalVolume;
 class G4GlobalMagFieldMessenger;
 
 namespace B4c
 {
 
+class DetectorMessenger;
+
 /// Detector construction class to define materials and geometry.
 ///
 /// In ConstructSDandField() sensitive detectors of CalorimeterSD type
 /// are created.
 /// In addition a transverse uniform magnetic field is defined
 /// via G4GlobalMagFieldMessenger class.
+/// The nanoparticles are a G4PVParameterised lattice of integer counts
+/// (NanoparticleGridParameterisation) inside a water container, which can
+/// be configured via the /microyz/det/ commands of DetectorMessenger.
+/// The sensitive detectors are wrapped in the "Nanodosimetry" G4Region,
+/// extended by a margin (/microyz/det/regionMargin), in which PhysicsList
+/// can switch to Geant4-DNA models (/microyz/phys/dnaRegion).
+/// The region has its own production cut (/microyz/det/regionCut), so the
+/// world can be run with coarse cuts (/run/setCut).
+/// G4UserLimits (max step, max track length, min kinetic energy) can be
+/// attached to any logical volume by name via the /microyz/limits/ commands,
+/// they are applied by G4StepLimiter and G4UserSpecialCuts of PhysicsList.
+/// Nested water shells around the grid container (/microyz/biasing/
+/// commands) define importances for ImportanceBiasingOperator, which splits
+/// the biased particles (/microyz/phys/biasing) moving towards the sensitive
+/// detectors and plays Russian roulette with those moving away.
+/// A water slab at the upstream end of the world, the "TransportEnvelope"
+/// region (/microyz/fastsim/ commands), lets ProtonTransportModel move the
+/// primary protons to the grid in one step. The envelope and the shells
+/// inherit the user limits of the world.
+/// The material table is only printed with /microyz/det/verbose 1.
 
 class DetectorConstruction : public G4VUserDetectorConstruction
 {
@@ -56,18 +81,67 @@ class DetectorConstruction : public G4VUserDetectorConstruction
     G4VPhysicalVolume* Construct() override;
     void ConstructSDandField() override;
 
+    // Set methods
+    void SetGridCounts(G4int nx, G4int ny, G4int nz);
+    void SetGridPitch(G4double pitch);
+    void SetGridPosition(const G4ThreeVector& position);
+    void SetRegionMargin(G4double margin);
+    void SetRegionCut(G4double cut);
+    void SetVerboseLevel(G4int level);
+
+    // Importance shells around the grid container (/microyz/biasing/ commands)
+    void SetNofShells(G4int nofShells);
+    void SetShellThickness(G4double thickness);
+    void SetSplittingFactor(G4double factor);
+
+    // Fast proton transport upstream of the grid (/microyz/fastsim/ commands)
+    void SetEnvelopeLength(G4double length);
+    void SetFastSimMinEnergy(G4double energy);
+
+    // User limits of a logical volume (/microyz/limits/ commands)
+    void SetMaxStep(const G4String& volume, G4double maxStep);
+    void SetMaxTrackLength(const G4String& volume, G4double maxTrackLength);
+    void SetMinKineticEnergy(const G4String& volume, G4double minKineticEnergy);
+
   private:
+    struct VolumeLimits
+    {
+      G4double fMaxStep = DBL_MAX;
+      G4double fMaxTrackLength = DBL_MAX;
+      G4double fMinKineticEnergy = 0.;
+    };
+
     // Methods
     //
     void DefineMaterials();
     G4VPhysicalVolume* DefineVolumes();
+    void ApplyUserLimits();
 
     // Data members
     //
     static G4ThreadLocal G4GlobalMagFieldMessenger*  fMagFieldMessenger;
                                       // magnetic field messenger
 
-    G4bool fCheckOverlaps = true; // option to activate checking of volumes overlaps
+    DetectorMessenger* fMessenger = nullptr;
+
+    G4bool   fCheckOverlaps = true; // option to activate checking of volumes overlaps
+    G4int    fGridNx = 11;         // number of nanoparticles along x
+    G4int    fGridNy = 11;         // number of nanoparticles along y
+    G4int    fGridNz = 11;         // number of nanoparticles along z
+    G4double fGridPitch;           // centre-to-centre distance of the nanoparticles
+    G4ThreeVector fGridPosition;   // centre of the nanoparticle grid
+    G4int    fNofSDs = 1;          // number of sensitive detectors (nanoparticles)
+    G4double fRegionMargin;        // margin of the Nanodosimetry region around the SDs
+    G4double fRegionCut;           // production cut in the Nanodosimetry region
+    G4int    fVerboseLevel = 0;    // >= 1 prints the material table
+    G4int    fNofShells = 0;       // number of importance shells, 0 disables the biasing
+    G4int    fNofShellsBuilt = 0;  // importance shells which fit into the world
+    G4double fShellThickness;      // thickness of the importance shells
+    G4double fSplittingFactor = 2.; // importance ratio of neighbouring shells
+    G4double fEnvelopeLength = 0.; // length of the transport envelope, 0 disables it
+    G4double fEnvelopeGap = 0.;    // gap between the transport envelope and the grid
+    G4double fFastSimMinEnergy;    // minimum exit energy of the fast proton transport
+    std::map<G4String, VolumeLimits> fVolumeLimits; // user limits per logical volume
 //    G4int  fNofLayers = -1;     // number of layers
 };
 
@@ -32,23 +32,34 @@
 
 #include "G4UserEventAction.hh"
 
-#include "CalorHit.hh"
-
 #include "globals.hh"
 
+namespace B4
+{
+class RunData;
+}
+
 namespace B4c
 {
 
+class CalorimeterSD;
+
 /// Event action class
 ///
 /// In EndOfEventAction(), it prints the accumulated quantities of the energy
 /// deposit and track lengths of charged particles in Absober and Gap layers
-/// stored in the hits collections.
+/// stored in the hit store of the CalorimeterSD of this thread.
+///
+/// The histograms, the ntuple, the cluster-size distribution and the text
+/// records are filled with the event weight of the primary vertex (source
+/// biasing). When the track weights differ from it (splitting, roulette), the
+/// values of the event are estimated from the track weighted sums of the hit,
+/// see CalorHit::GetEventValues().
 
 class EventAction : public G4UserEventAction
 {
 public:
-  EventAction();
+  EventAction(B4::RunData* runData);
   ~EventAction() override;
 
   void  BeginOfEventAction(const G4Event* event) override;
@@ -56,10 +67,11 @@ public:
 
 private:
   // Methods
-  CalorHitsCollection* GetHitsCollection(G4int hcID, const G4Event* event) const;
+  const CalorimeterSD* GetCalorimeterSD();
 
   // Data members
-  G4int fSensitiveDetectorHCID = -1; // Declare the hits collection ID for the SensitiveDetector
+  B4::RunData* fRunData = nullptr;               // of this thread
+  const CalorimeterSD* fCalorimeterSD = nullptr; // SensitiveDetector of this thread
 
 /*  CalorHitsCollection* GetHitsCollection(G4int hcID,
                                             const G4Event* event) const;
@@ -0,0 +1,91 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ImportanceBiasingOperator.hh
+/// \brief Definition of the B4c::ImportanceBiasingOperator class
+
+#ifndef B4cImportanceBiasingOperator_h
+#define B4cImportanceBiasingOperator_h 1
+
+#include "G4VBiasingOperator.hh"
+#include "globals.hh"
+
+#include <map>
+
+class G4LogicalVolume;
+
+namespace B4c
+{
+
+class SplitOrRouletteOperation;
+
+/// Geometry importance biasing operator.
+///
+/// Each logical volume the operator is attached to gets an importance
+/// (SetImportance()). When a biased particle crosses a boundary from a
+/// volume of importance I_pre into one of importance I_post, the
+/// SplitOrRouletteOperation
+/// - splits it into I_post/I_pre copies of weight w*I_pre/I_post if the
+///   importance increases,
+/// - plays Russian roulette with the survival probability I_post/I_pre and
+///   gives the survivor the weight w*I_pre/I_post if it decreases.
+/// Volumes without importance (e.g. the daughters of the attached volumes)
+/// are ignored.
+///
+/// The particles are selected in the physics list (/microyz/phys/biasing),
+/// which adds the G4BiasingProcessInterface through G4GenericBiasingPhysics.
+/// One operator has to be created per thread, in
+/// DetectorConstruction::ConstructSDandField().
+
+class ImportanceBiasingOperator : public G4VBiasingOperator
+{
+  public:
+    ImportanceBiasingOperator(const G4String& name);
+    ~ImportanceBiasingOperator() override;
+
+    // Attach the operator to the volume and set its importance
+    void SetImportance(const G4LogicalVolume* volume, G4double importance);
+
+    // Importance of the volume, 0 if the operator is not attached to it
+    G4double GetImportance(const G4LogicalVolume* volume) const;
+
+  private:
+    G4VBiasingOperation* ProposeNonPhysicsBiasingOperation(
+      const G4Track* track, const G4BiasingProcessInterface* callingProcess) override;
+    G4VBiasingOperation* ProposeOccurenceBiasingOperation(
+      const G4Track*, const G4BiasingProcessInterface*) override { return nullptr; }
+    G4VBiasingOperation* ProposeFinalStateBiasingOperation(
+      const G4Track*, const G4BiasingProcessInterface*) override { return nullptr; }
+
+    SplitOrRouletteOperation* fSplitOrRouletteOperation = nullptr;
+    std::map<const G4LogicalVolume*, G4double> fImportances;
+};
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,70 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file NanoparticleGridParameterisation.hh
+/// \brief Definition of the B4c::NanoparticleGridParameterisation class
+
+#ifndef B4cNanoparticleGridParameterisation_h
+#define B4cNanoparticleGridParameterisation_h 1
+
+#include "G4VPVParameterisation.hh"
+#include "globals.hh"
+
+class G4VPhysicalVolume;
+
+namespace B4c
+{
+
+/// Parameterisation of a regular nx x ny x nz lattice of nanoparticles.
+///
+/// The copy number is ix + nx*(iy + ny*iz); positions are computed from the
+/// integer indices relative to the centre of the mother volume, so the number
+/// of planes never depends on floating-point accumulation.
+
+class NanoparticleGridParameterisation : public G4VPVParameterisation
+{
+  public:
+    NanoparticleGridParameterisation(G4int nx, G4int ny, G4int nz,
+                                     G4double pitch);
+    ~NanoparticleGridParameterisation() override;
+
+    void ComputeTransformation(const G4int copyNo,
+                               G4VPhysicalVolume* physVol) const override;
+
+    G4int GetNofCopies() const { return fNx * fNy * fNz; }
+
+  private:
+    G4int    fNx = 1;
+    G4int    fNy = 1;
+    G4int    fNz = 1;
+    G4double fPitch = 0.;
+};
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
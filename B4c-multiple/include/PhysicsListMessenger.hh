@@ -60,6 +60,10 @@ class PhysicsListMessenger: public G4UImessenger
     
     G4UIdirectory*             fPhysDir;        
     G4UIcmdWithAString*        fListCmd;
+    G4UIcmdWithAString*        fDnaRegionCmd;
+    G4UIcmdWithAString*        fTableCacheCmd;
+    G4UIcmdWithAString*        fBiasingCmd;
+    G4UIcmdWithAString*        fFastSimulationCmd;
     
 };
 
@@ -0,0 +1,117 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhysicsTableCache.hh
+/// \brief Definition of the B4::PhysicsTableCache class
+
+#ifndef B4PhysicsTableCache_h
+#define B4PhysicsTableCache_h 1
+
+#include "G4VStateDependent.hh"
+#include "globals.hh"
+
+#include <chrono>
+
+class G4VUserPhysicsList;
+
+namespace B4
+{
+
+/// Cache of the physics tables and report of the startup times
+///
+/// With a cache directory (/microyz/phys/tableCache) the physics tables
+/// built at the first run are stored in a subdirectory named by a hash of
+/// - the Geant4 version and the physics list configuration (SetConfiguration()),
+/// - the EM parameters (G4EmParameters::StreamInfo()),
+/// - the default cut, the production cuts of all regions and the energy
+///   range of the cuts table,
+/// - the materials (name, density, element fractions).
+/// A later job with the same key retrieves them instead of building them
+/// (G4VUserPhysicsList::SetPhysicsTableRetrieved()); Geant4 itself checks
+/// the stored materials and cuts and rebuilds the tables that do not match.
+/// The tables are written into a temporary directory renamed into place
+/// once complete, so concurrent jobs sharing the cache never read a
+/// partial directory; the first job to finish keeps its tables.
+/// Data files read by the models at initialisation (e.g. Geant4-DNA cross
+/// sections) are not cached.
+///
+/// The phases are timed through the application state transitions of the
+/// master: application setup (from the construction of the physics list),
+/// /run/initialize (geometry and processes), physics tables (initialisation
+/// of the first run). They are printed once the first run is initialised.
+///
+/// The object is registered with the G4StateManager of the creating thread,
+/// which deletes it.
+
+class PhysicsTableCache : public G4VStateDependent
+{
+  public:
+    PhysicsTableCache(G4VUserPhysicsList* physicsList);
+    ~PhysicsTableCache() override = default;
+
+    // Cache directory, "none" disables the cache
+    void SetDirectory(const G4String& directory);
+
+    // Physics list description, part of the key
+    void SetConfiguration(const G4String& configuration) { fConfiguration = configuration; }
+
+    G4bool Notify(G4ApplicationState requestedState) override;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    G4String ComputeKey() const;
+    void Retrieve();
+    void Store();
+    void Report() const;
+
+    G4VUserPhysicsList* fPhysicsList = nullptr;
+    G4String fDirectory;
+    G4String fConfiguration;
+
+    // Key and subdirectory of the current tables
+    G4String fKey;
+    G4String fTableDirectory;
+    G4bool fRetrieved = false;
+    G4bool fStored = false;
+
+    // Startup phases
+    G4bool fInitialised = false;
+    G4bool fTablesStarted = false;
+    G4bool fTablesDone = false;
+    Clock::time_point fStart;
+    Clock::time_point fInitStart;
+    Clock::time_point fInitEnd;
+    Clock::time_point fTablesStart;
+    Clock::time_point fTablesEnd;
+    G4double fStoreTime = 0.;
+};
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
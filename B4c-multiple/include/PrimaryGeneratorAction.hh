@@ -33,19 +33,40 @@
 #include "G4VUserPrimaryGeneratorAction.hh"
 #include "globals.hh"
 
+#include "PhaseSpaceReader.hh"
+
+#include "G4ThreeVector.hh"
+
 // GPS is more advanced than G4ParticleHGun
 class G4GeneralParticleSource;
 class G4Event;
+class G4PrimaryVertex;
 
 namespace B4
 {
 
+class PrimaryGeneratorMessenger;
+
 /// The primary generator action class with particle gum.
 ///
 /// It defines a single particle which hits the calorimeter
 /// perpendicular to the input face. The type of the particle
 /// can be changed via the G4 build-in commands of G4ParticleGun class
 /// (see the macros provided with this example).
+///
+/// With /microyz/source/phaseSpaceFile set, the primaries are read from a
+/// phase-space file (PhaseSpaceReader) instead, and the run is stopped when
+/// the requested passes over the file are exhausted.
+///
+/// Source biasing (/microyz/source/biasFraction): a fraction p of the GPS
+/// positions is resampled uniformly in the projection of the Nanodosimetry
+/// region (plus /microyz/source/biasMargin) onto the source plane. The
+/// primary vertex gets the ratio of the analog to the biased position
+/// density as weight, 1 / (p A / A_b + 1 - p) inside the projection of area
+/// A_b and 1 / (1 - p) outside, A being the area of the source. The analog
+/// source is kept as part of the mixture, so the weighted results are
+/// unbiased for any margin. It requires a GPS of type Plane, shape Circle,
+/// Square or Rectangle, perpendicular to z.
 
 class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 {
@@ -57,10 +78,31 @@ public:
 
   // Set methods
   void SetRandomFlag(G4bool value);
+  void SetBiasFraction(G4double fraction) { fBiasFraction = fraction; fPrintBias = true; }
+  void SetBiasMargin(G4double margin) { fBiasMargin = margin; fPrintBias = true; }
+
+  // Phase-space replay
+  PhaseSpaceReader& GetPhaseSpaceReader() { return fPhaseSpaceReader; }
 
 private:
+  // Source biasing toward the nanoparticle grid
+  G4bool FindBiasArea();
+  void BiasVertex(G4PrimaryVertex* vertex);
+
   // Member variable, storing the GPS instance which encapsules e.g. position, energy, direction...
   G4GeneralParticleSource* fParticleGun = nullptr;
+
+  // Replay of a phase-space file, replaces the GPS when enabled
+  PhaseSpaceReader fPhaseSpaceReader;
+  PrimaryGeneratorMessenger* fMessenger = nullptr;
+
+  // Source biasing, p = fBiasFraction (0 = analog source)
+  G4double fBiasFraction = 0.;
+  G4double fBiasMargin;          // margin around the projected region
+  G4bool fBiasAreaFound = false;
+  G4bool fPrintBias = true;
+  G4ThreeVector fBiasCenter;     // centre of the projected region
+  G4ThreeVector fBiasHalfSize;   // half size of the projected region
 };
 
 }
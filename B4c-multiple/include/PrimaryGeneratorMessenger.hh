@@ -0,0 +1,80 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PrimaryGeneratorMessenger.hh
+/// \brief Definition of the B4::PrimaryGeneratorMessenger class
+
+#ifndef B4PrimaryGeneratorMessenger_h
+#define B4PrimaryGeneratorMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWith3VectorAndUnit;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+
+namespace B4
+{
+
+class PrimaryGeneratorAction;
+
+/// Messenger of the primary generator action
+///
+/// /microyz/source/ commands replace the GPS by the replay of a phase-space
+/// file or bias the GPS positions toward the nanoparticle grid. As the /gps/
+/// commands, they are only known to the worker threads and are forwarded
+/// there by the master.
+
+class PrimaryGeneratorMessenger : public G4UImessenger
+{
+  public:
+    PrimaryGeneratorMessenger(PrimaryGeneratorAction* action);
+    ~PrimaryGeneratorMessenger() override;
+
+    void SetNewValue(G4UIcommand* command, G4String newValue) override;
+
+  private:
+    PrimaryGeneratorAction*     fAction = nullptr;
+
+    G4UIdirectory*              fSourceDir = nullptr;
+    G4UIcmdWithAString*         fFileCmd = nullptr;
+    G4UIcmdWithAnInteger*       fPassesCmd = nullptr;
+    G4UIcmdWith3VectorAndUnit*  fShiftCmd = nullptr;
+    G4UIcmdWithABool*           fRandomRotationCmd = nullptr;
+    G4UIcmdWithADouble*         fBiasFractionCmd = nullptr;
+    G4UIcmdWithADoubleAndUnit*  fBiasMarginCmd = nullptr;
+};
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,108 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ProtonTransportModel.hh
+/// \brief Definition of the B4c::ProtonTransportModel class
+
+#ifndef B4cProtonTransportModel_h
+#define B4cProtonTransportModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4Material;
+
+namespace B4c
+{
+
+/// Fast simulation of the primary proton transport through an envelope.
+///
+/// A primary proton inside the envelope region ("TransportEnvelope", see
+/// DetectorConstruction) is moved to the envelope surface along its
+/// direction in a single step:
+/// - the mean energy loss follows from the CSDA range, tabulated from the
+///   Bethe formula with density effect correction in the envelope material,
+/// - the energy loss straggling is Gaussian (Bohr variance with the
+///   relativistic factor of G4UniversalFluctuation),
+/// - the deflection and the correlated lateral displacement are sampled
+///   with the Highland width of the multiple scattering angle.
+/// No secondaries are produced, the energy loss is deposited in the envelope.
+/// The formulas hold for protons of a few MeV and more: the model only
+/// triggers if the proton leaves the envelope with a mean kinetic energy
+/// above the minimum energy (/microyz/fastsim/minEnergy), otherwise the
+/// full simulation takes over.
+/// Delta electrons are not produced in the envelope either, only those of
+/// the gap between the envelope and the grid (SetGap()) reach the grid. The
+/// first time a proton of a higher energy is moved, the CSDA range of its
+/// fastest delta electrons is compared with the gap and a warning is issued
+/// if the gap is shorter.
+///
+/// The model is created per thread in DetectorConstruction::ConstructSDandField();
+/// PhysicsList adds the fast simulation process (/microyz/phys/fastSimulation).
+/// It can be switched off with /param/inActivateModel ProtonTransport.
+
+class ProtonTransportModel : public G4VFastSimulationModel
+{
+  public:
+    ProtonTransportModel(const G4String& name, G4Region* envelope);
+    ~ProtonTransportModel() override = default;
+
+    void SetMinEnergy(G4double energy) { fMinEnergy = energy; }
+    void SetGap(G4double gap) { fGap = gap; }
+
+    G4bool IsApplicable(const G4ParticleDefinition& particle) override;
+    G4bool ModelTrigger(const G4FastTrack& fastTrack) override;
+    void DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep) override;
+
+  private:
+    // Tabulate the range in the material (done at the first use)
+    void Initialise(const G4Material* material);
+
+    G4double ComputeDEDX(G4double energy) const;
+    G4double GetRange(G4double energy) const;
+    G4double GetEnergy(G4double range) const;
+
+    // Warn if the delta electrons of a proton of this energy can cross the gap
+    void CheckGap(G4double energy);
+
+    G4double fMinEnergy;
+    G4double fGap;                 // distance from the envelope to the grid
+    G4double fCheckedEnergy = 0.;  // highest proton energy checked by CheckGap()
+
+    // CSDA range of protons on a logarithmic energy grid
+    const G4Material* fMaterial = nullptr;
+    std::vector<G4double> fRanges;
+    G4double fLogEmin = 0.;
+    G4double fInvLogStep = 0.;
+};
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
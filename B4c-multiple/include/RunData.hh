@@ -0,0 +1,158 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file RunData.hh
+/// \brief Definition of the B4::RunData class
+
+#ifndef B4RunData_h
+#define B4RunData_h 1
+
+#include "globals.hh"
+#include "G4Accumulable.hh"
+
+#include "ClusterSizeAccumulator.hh"
+#include "IonisationClassifier.hh"
+#include "OutputShard.hh"
+#include "PhaseSpaceWriter.hh"
+#include "RoiTrackFilter.hh"
+
+namespace B4
+{
+
+class SharedRunData;
+
+/// Data of the run of one thread
+///
+/// ActionInitialization creates one RunData per thread and hands it to the
+/// actions of the thread (RunAction, EventAction, StackingAction,
+/// SteppingAction); the RunAction owns it and passes it on to CalorimeterSD
+/// at the start of each run. It holds:
+/// - the per-event (data.txt) and per-nanoparticle (cells.txt) output shards,
+/// - the cluster-size distribution of the thread,
+/// - the ionisation processes resolved for the thread,
+/// - the RoiTrackFilter and the phase-space capture of the thread,
+/// - the counters of the run, registered to G4AccumulableManager and merged
+///   over the threads at the end of the run,
+/// - the output and scoring options (/microyz/output/, /microyz/scoring/).
+///
+/// The state shared by all threads is reached with GetShared().
+
+class RunData
+{
+  public:
+    RunData(SharedRunData* sharedRunData);
+    ~RunData() = default;
+
+    // State of the run shared by all threads
+    SharedRunData& GetShared() const { return *fSharedRunData; }
+
+    // Per-event and per-nanoparticle output of this thread
+    OutputShard& GetEventOutput() { return fEventOutput; }
+    OutputShard& GetCellOutput() { return fCellOutput; }
+
+    // Cluster-size distribution of this thread
+    ClusterSizeAccumulator& GetClusterSizes() { return fClusterSizes; }
+
+    // Ionisation classification of secondaries
+    IonisationClassifier& GetIonisationClassifier() { return fIonisationClassifier; }
+
+    // Killing of tracks that can not reach the region of interest
+    RoiTrackFilter& GetRoiTrackFilter() { return fRoiTrackFilter; }
+
+    // Phase-space capture of this thread
+    PhaseSpaceWriter& GetPhaseSpaceWriter() { return fPhaseSpaceWriter; }
+
+    // Enable/disable the per-event text records
+    void   SetWriteEventRecords(G4bool value) { fWriteEventRecords = value; }
+    G4bool GetWriteEventRecords() const { return fWriteEventRecords; }
+
+    // Write the energies and weights of the records with all the digits
+    // of a double, for bit-wise comparisons of runs
+    void   SetFullPrecision(G4bool value) { fFullPrecision = value; }
+    G4bool IsFullPrecision() const { return fFullPrecision; }
+
+    // Make a hits collection of the event from the hit store of the SD,
+    // only needed by code reading G4HCofThisEvent
+    void   SetMakeHitsCollection(G4bool value) { fMakeHitsCollection = value; }
+    G4bool GetMakeHitsCollection() const { return fMakeHitsCollection; }
+
+    // Make the hits collection with a hit of every cell, as allocated by the
+    // former per-event design, the baseline of the hit store benchmark
+    void   SetAllCellsHitsCollection(G4bool value) { fAllCellsHitsCollection = value; }
+    G4bool GetAllCellsHitsCollection() const { return fAllCellsHitsCollection; }
+
+    // Counts of this thread
+    void AddKilledTracks(G4long stacked, G4long inFlight, G4double residualRange);
+    void AddTrackedStep(G4double length);
+    void AddStepFilterCounts(G4long processed, G4long noDeposit,
+                             G4long classified, G4long recorded);
+
+    // Counts of the run, merged over the threads at the end of the run
+    G4long GetNofStepsProcessed() const { return fNofStepsProcessed.GetValue(); }
+    G4long GetNofStepsNoDeposit() const { return fNofStepsNoDeposit.GetValue(); }
+    G4long GetNofStepsClassified() const { return fNofStepsClassified.GetValue(); }
+    G4long GetNofStepsRecorded() const { return fNofStepsRecorded.GetValue(); }
+    G4long GetNofTracksKilledStacked() const { return fNofTracksKilledStacked.GetValue(); }
+    G4long GetNofTracksKilledInFlight() const { return fNofTracksKilledInFlight.GetValue(); }
+    G4long GetNofStepsTracked() const { return fNofStepsTracked.GetValue(); }
+    G4double GetTrackLengthTracked() const { return fTrackLengthTracked.GetValue(); }
+    G4double GetResidualRangeKilled() const { return fResidualRangeKilled.GetValue(); }
+
+  private:
+    SharedRunData* fSharedRunData = nullptr;
+
+    OutputShard fEventOutput;
+    OutputShard fCellOutput;
+    ClusterSizeAccumulator fClusterSizes;
+    IonisationClassifier fIonisationClassifier;
+    RoiTrackFilter fRoiTrackFilter;
+    PhaseSpaceWriter fPhaseSpaceWriter;
+
+    G4bool fWriteEventRecords = true;
+    G4bool fFullPrecision = false;
+    G4bool fMakeHitsCollection = false;
+    G4bool fAllCellsHitsCollection = false;
+
+    // Step filter counts of CalorimeterSD::ProcessHits()
+    G4Accumulable<G4long> fNofStepsProcessed = 0;
+    G4Accumulable<G4long> fNofStepsNoDeposit = 0;
+    G4Accumulable<G4long> fNofStepsClassified = 0;
+    G4Accumulable<G4long> fNofStepsRecorded = 0;
+
+    // Track killing outside the region of interest: the killed tracks and
+    // the CSDA range they had left, the steps tracked with the filter on
+    G4Accumulable<G4long> fNofTracksKilledStacked = 0;
+    G4Accumulable<G4long> fNofTracksKilledInFlight = 0;
+    G4Accumulable<G4double> fResidualRangeKilled = 0.;
+    G4Accumulable<G4long> fNofStepsTracked = 0;
+    G4Accumulable<G4double> fTrackLengthTracked = 0.;
+};
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
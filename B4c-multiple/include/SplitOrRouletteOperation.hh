@@ -0,0 +1,79 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SplitOrRouletteOperation.hh
+/// \brief Definition of the B4c::SplitOrRouletteOperation class
+
+#ifndef B4cSplitOrRouletteOperation_h
+#define B4cSplitOrRouletteOperation_h 1
+
+#include "G4VBiasingOperation.hh"
+#include "G4ParticleChange.hh"
+#include "globals.hh"
+
+namespace B4c
+{
+
+class ImportanceBiasingOperator;
+
+/// Splitting / Russian roulette of a track at the boundary between two
+/// volumes of different importance (see ImportanceBiasingOperator).
+///
+/// The operation is forced at each step of a biased particle and acts only
+/// on steps limited by the geometry. For a non-integer importance ratio r
+/// the number of copies is floor(r) or floor(r)+1, with mean r.
+
+class SplitOrRouletteOperation : public G4VBiasingOperation
+{
+  public:
+    SplitOrRouletteOperation(const G4String& name,
+                             const ImportanceBiasingOperator* biasingOperator);
+    ~SplitOrRouletteOperation() override = default;
+
+    // Not an occurrence or final state biasing
+    const G4VBiasingInteractionLaw* ProvideOccurenceBiasingInteractionLaw(
+      const G4BiasingProcessInterface*, G4ForceCondition&) override { return nullptr; }
+    G4VParticleChange* ApplyFinalStateBiasing(
+      const G4BiasingProcessInterface*, const G4Track*, const G4Step*,
+      G4bool&) override { return nullptr; }
+
+    // Non-physics biasing
+    G4double DistanceToApplyOperation(const G4Track* track,
+                                      G4double previousStepSize,
+                                      G4ForceCondition* condition) override;
+    G4VParticleChange* GenerateBiasingFinalState(const G4Track* track,
+                                                 const G4Step* step) override;
+
+  private:
+    const ImportanceBiasingOperator* fOperator = nullptr;
+    G4ParticleChange fParticleChange;
+};
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -31,7 +31,11 @@
 #include "ActionInitialization.hh"
 #include "PrimaryGeneratorAction.hh"
 #include "RunAction.hh"
+#include "RunData.hh"
+#include "SharedRunData.hh"
 #include "EventAction.hh"
+#include "StackingAction.hh"
+#include "SteppingAction.hh"
 
 // Use namespace
 using namespace B4;
@@ -44,20 +48,23 @@ namespace B4c
 
 // Constructor --> to initialize user actions
 ActionInitialization::ActionInitialization()
+ : fSharedRunData(new SharedRunData)
 {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 // Destrutor --> clean up any dynamically allocated resources used
 ActionInitialization::~ActionInitialization()
-{}
+{
+  delete fSharedRunData;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 // Master thread actions initialization --> handles data accumulation from worker threads
 void ActionInitialization::BuildForMaster() const
 { // Tasks for the master tread
-  SetUserAction(new RunAction);
+  SetUserAction(new RunAction(new RunData(fSharedRunData)));
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -66,8 +73,11 @@ void ActionInitialization::BuildForMaster() const
 void ActionInitialization::Build() const
 { // Tasks for the worker threads
   SetUserAction(new PrimaryGeneratorAction);
-  SetUserAction(new RunAction);
-  SetUserAction(new EventAction);
+  auto runData = new RunData(fSharedRunData);  // owned by the RunAction
+  SetUserAction(new RunAction(runData));
+  SetUserAction(new EventAction(runData));
+  SetUserAction(new StackingAction(runData));
+  SetUserAction(new SteppingAction(runData));
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
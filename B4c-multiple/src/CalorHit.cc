@@ -34,6 +34,7 @@
 #include "G4Circle.hh"
 #include "G4Colour.hh"
 #include "G4VisAttributes.hh"
+#include <cmath>
 #include <iomanip>
 
 // fEdep --> energy deposition
@@ -84,6 +85,32 @@ G4bool CalorHit::operator==(const CalorHit& right) const
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+// Values of the event: the sums themselves when all steps carry the event
+// weight (analog or source biasing). Otherwise the weighted sums relative to
+// the event weight, the event with its weight then reproduces the weighted
+// sums; the cluster size is kept as the non-integer weighted count, which
+// ClusterSizeAccumulator::Fill() shares between the neighbouring bins.
+G4bool CalorHit::GetEventValues(G4double eventWeight, G4double& edep,
+                                G4double& trackLength, G4double& ionYield) const
+{
+  const G4double tolerance = 1.e-9 * eventWeight;
+  if ( fMaxWeight == 0.
+       || ( std::abs(fMinWeight - eventWeight) <= tolerance
+            && std::abs(fMaxWeight - eventWeight) <= tolerance ) ) {
+    edep = fEdep;
+    trackLength = fTrackLength;
+    ionYield = fIonYield;
+    return true;
+  }
+
+  edep = fWeightedEdep / eventWeight;
+  trackLength = fWeightedTrackLength / eventWeight;
+  ionYield = fWeightedIonYield / eventWeight;
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 // Define print function
 // std::setw(7) --> ensures 7-character wide output for formatting
 void CalorHit::Print()
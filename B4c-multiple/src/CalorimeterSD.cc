@@ -36,6 +36,8 @@
 #include "G4ios.hh" // Provides input/output functionalities
 #include "G4VProcess.hh"
 
+#include "RunData.hh"
+
 namespace B4c
 {
 
@@ -44,7 +46,8 @@ namespace B4c
 CalorimeterSD::CalorimeterSD(const G4String& name,		// name of sensitive detector
                              const G4String& hitsCollectionName,// name for storing hit data
                              G4int nofCells) 			// no. of cells/layers
- : G4VSensitiveDetector(name), fNofCells(nofCells) 		// registers the hits collection name
+ : G4VSensitiveDetector(name), 					// registers the hits collection name
+   fHitStore(nofCells), fNofCells(nofCells)			// hits reused by all events of the thread
 {
   collectionName.insert(hitsCollectionName);
 }
@@ -56,22 +59,19 @@ CalorimeterSD::~CalorimeterSD()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void CalorimeterSD::Initialize(G4HCofThisEvent* hce) // called at beginning of each event to set up the hit collection
+void CalorimeterSD::SetRunData(B4::RunData* runData)
 {
-  // Create hits collection to store hits
-  fHitsCollection
-    = new CalorHitsCollection(SensitiveDetectorName, collectionName[0]);
+  // Ionisation classifier of this thread, resolved in BeginOfRunAction()
+  fRunData = runData;
+  fIonisationClassifier = &fRunData->GetIonisationClassifier();
+}
 
-  // Add this collection in hce
-  auto hcID
-    = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
-  hce->AddHitsCollection( hcID, fHitsCollection );
-
-  // Create hits
-  // fNofCells for cells + one more for total sums
-  for (G4int i=0; i<fNofCells+1; i++ ) {
-    fHitsCollection->insert(new CalorHit());
-  }
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CalorimeterSD::Initialize(G4HCofThisEvent*) // called at beginning of each event to reset the hits
+{
+  // Clear the total hit and the cells touched in the previous event
+  fHitStore.Reset();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -81,6 +81,8 @@ void CalorimeterSD::Initialize(G4HCofThisEvent* hce) // called at beginning of e
 G4bool CalorimeterSD::ProcessHits(G4Step* step,
                                      G4TouchableHistory*)
 {
+  ++fNofStepsProcessed;
+
   // Energy deposit
   auto edep = step->GetTotalEnergyDeposit();
 
@@ -90,141 +92,106 @@ G4bool CalorimeterSD::ProcessHits(G4Step* step,
     stepLength = step->GetStepLength();
   }
 
-
-////////////////// IONIZATION COUNTER /////////////////
-G4int nIon = 0;
-
-if (step->GetPreStepPoint()->GetPhysicalVolume()->GetName() == "SensitiveDetector") {
-    const auto secondaries = step->GetSecondaryInCurrentStep();
-    for (const auto& sec : *secondaries) {
-        if (sec->GetCreatorProcess() &&
-            sec->GetCreatorProcess()->GetProcessName().find("Ioni") != std::string::npos &&
-            sec->GetDefinition()->GetParticleName() == "e-") {
-            nIon++;
-        }
-    }
-}
-
-
-
-/*G4int nIon = 0;
-if (step->GetPreStepPoint()->GetPhysicalVolume()->GetName() == "SensitiveDetector") {
-    if (step->GetTotalEnergyDeposit() != 0) {
-      G4String process_name = step->GetPostStepPoint()->GetProcessDefinedStep()->GetProcessName();
-
-      auto pos = process_name.find("Ioni"); 	// looking for "Ioni" substring in process_name
-      if (pos != std::string::npos) {  		// found!
-
- const auto secondaries = step->GetSecondaryInCurrentStep();
-  for (const auto& sec : *secondaries) {
-      if (sec->GetDefinition()->GetParticleName() == "e-"){
-
-        nIon++;} 				// increase cluster size
-    }
+  // Ignore steps with no energy loss and no movement --> avoids unnecessary calculations
+  // (cheapest gate first, neutral steps without deposit stop here)
+  if ( edep == 0. && stepLength == 0. ) {
+    ++fNofStepsNoDeposit;
+    return false;
   }
 
-}
-}
-*/
-/*
 
-////////////////// CHECK FOR MULTIPLE SPECIFIC PROCESSES ////////////////
+////////////////// IONIZATION COUNTER /////////////////
+// Secondary electrons of the ionisation processes resolved at run start
+// (/microyz/scoring/ionisationProcesses), compared by pointer. No volume
+// check needed, ProcessHits() is only called inside the SensitiveDetector.
+// Only steps which produced secondaries need to be classified.
 G4int nIon = 0;
 const auto secondaries = step->GetSecondaryInCurrentStep();
-for (const auto& sec : *secondaries) {
-    const auto* creator = sec->GetCreatorProcess();
-    if (creator) {
-        const G4String& pname = creator->GetProcessName();
-        const bool eIoni = pname == "e-_G4DNAIonisation";
-        const bool hIoni = pname == "proton_G4DNAIonisation";
-        if (eIoni || hIoni) {
-            nIon++;
-        }
-    }
+if ( ! secondaries->empty() ) {
+  ++fNofStepsClassified;
+  nIon = fIonisationClassifier->CountIonisations(secondaries);
 }
-*/
-
-/*
-///////////////// CHECK FOR SINGULAR SPECIFIC PROCESS //////////////////
-  // Ionization yield
-  // Count ionizations (based on secondary electron production)
-  G4int nIon = 0;
-  const auto secondaries = step->GetSecondaryInCurrentStep();
-  for (const auto& sec : *secondaries) {
-     if (sec->GetCreatorProcess()->GetProcessName() == "e-_G4DNAIonisation") {nIon++;}
-  }
 
-*/
-// auto:         work with copy
-// auto&:        work with original
-// const:        prevents modifications
-
-/*
-///////////////// CHECK FOR ALL IONIZATION PROCESSES //////////////////
-  G4int nIon = 0;
-  const auto secondaries = step->GetSecondaryInCurrentStep();			// Get list of secondary particles in current step
-  for (const auto& sec : *secondaries) {					// Loop over  secondaries (by reference, read-only)
-      if (sec->GetDefinition()->GetParticleName() == "e-") {			// Check if secondary is electron
-          const G4VProcess* creator = sec->GetCreatorProcess();			// Get process that created electron
-          if (creator) {							// Not all particles have creator process, i.e. primary electrons should not be counted
-              const auto& pname = creator->GetProcessName();
-
-    G4cout << "[Secondary] "
-           << "Created by process: " << creator->GetProcessName()
-           << " | Particle: " << sec->GetDefinition()->GetParticleName()
-           << " | Position: " << sec->GetPosition()
-           << G4endl;
-
-			// Get creator process name
-              if (pname.find("Ioni") != std::string::npos) {			// .find() returns npos if "Ioni" is not found in pname
-                 //const auto* volume = sec->GetTouchableHandle()->GetVolume();   // Make sure the ionization happened in the SD --> unnecessary, we only count inside the SD to begin with???
-    		 //if (volume && volume->GetName() == "SensitiveDetector") {
-        	   nIon++;
-
-
-              }
-          }
-      }
-  }
-*/
-  // Ignore steps with no energy loss and no movement --> avoids unnecessary calculations
-  if ( edep==0. && stepLength == 0. ) return false;
-
-  // Get calorimeter cell when the hit occured
+  // Get nanoparticle (cell) when the hit occured
   auto touchable = (step->GetPreStepPoint()->GetTouchable());
-  auto layerNumber = touchable->GetReplicaNumber(1);
-
-  // Get hit accounting data for this cell
-  auto hit = (*fHitsCollection)[layerNumber];
-  if ( ! hit ) { // Check if the hit object for this specific calorimeter layer exists
+  auto cellNumber = touchable->GetCopyNumber();
+  if ( cellNumber < 0 || cellNumber >= fNofCells ) {
     G4ExceptionDescription msg;
-    msg << "Cannot access hit " << layerNumber;
+    msg << "Cannot access hit " << cellNumber;
     G4Exception("CalorimeterSD::ProcessHits()",
       "MyCode0004", FatalException, msg);
   }
 
-  // Get hit for total accounting --> accesses last element in the fHitsCollections which stores total accumulated data for ALL layers
-  auto hitTotal
-    = (*fHitsCollection)[fHitsCollection->entries()-1];
+  // Get hit accounting data for this cell, marked as touched in this event
+  auto& hit = fHitStore.Touch(cellNumber);
+
+  // Get hit for total accounting --> stores total accumulated data for ALL cells
+  auto& hitTotal = fHitStore.GetTotalHit();
 
   // Record energy deposition and step length into the hit objects
-  hit->Add(edep, stepLength, nIon);
-  hitTotal->Add(edep, stepLength, nIon);
+  // with the weight of the track, which carries the event weight of a
+  // biased source and the weights of splitting or roulette
+  auto weight = step->GetTrack()->GetWeight();
+  hit.Add(edep, stepLength, nIon, weight);
+  hitTotal.Add(edep, stepLength, nIon, weight);
+
+  ++fNofStepsRecorded;
 
   return true; // Indicate that a valid hit was recorded
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void CalorimeterSD::EndOfEvent(G4HCofThisEvent*)
+void CalorimeterSD::EndOfEvent(G4HCofThisEvent* hce)
 {
+  // Add the step filter counts of this event to the run
+  fRunData->AddStepFilterCounts(fNofStepsProcessed, fNofStepsNoDeposit,
+                                fNofStepsClassified, fNofStepsRecorded);
+  fNofStepsProcessed = 0;
+  fNofStepsNoDeposit = 0;
+  fNofStepsClassified = 0;
+  fNofStepsRecorded = 0;
+
+  // Make the hits collection of the event only when it is asked for:
+  // the total hit followed by the hits of the touched cells
+  G4bool allCells = fRunData->GetAllCellsHitsCollection();
+  if ( ! allCells && ! fRunData->GetMakeHitsCollection() && verboseLevel <= 0 ) return;
+
+  auto hitsCollection
+    = new CalorHitsCollection(SensitiveDetectorName, collectionName[0]);
+  if ( allCells ) {
+    // Benchmark baseline, as the former design: a hit for every cell
+    // followed by the total hit, allocated in every event
+    for ( G4int cell = 0; cell < fNofCells; ++cell ) {
+      auto cellHit = new CalorHit(fHitStore.GetCellHit(cell));
+      cellHit->SetCellID(cell);
+      hitsCollection->insert(cellHit);
+    }
+    hitsCollection->insert(new CalorHit(fHitStore.GetTotalHit()));
+  }
+  else {
+    hitsCollection->insert(new CalorHit(fHitStore.GetTotalHit()));
+    for ( auto cell : fHitStore.GetTouchedCells() ) {
+      auto cellHit = new CalorHit(fHitStore.GetCellHit(cell));
+      cellHit->SetCellID(cell);
+      hitsCollection->insert(cellHit);
+    }
+  }
+
+  // Add this collection in hce
+  if ( fHitsCollectionID < 0 ) {
+    fHitsCollectionID
+      = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
+  }
+  hce->AddHitsCollection( fHitsCollectionID, hitsCollection );
+
   if ( verboseLevel>0 /*1*/ ) {
-     auto nofHits = fHitsCollection->entries();
+     auto nofHits = hitsCollection->entries();
      G4cout
        << G4endl
        << "-------->Hits Collection: in this event there are " << nofHits
        << " hits in the tracker chambers: " << G4endl;
-     for ( std::size_t i=0; i<nofHits; ++i ) (*fHitsCollection)[i]->Print();
+     for ( std::size_t i=0; i<nofHits; ++i ) (*hitsCollection)[i]->Print();
   }
 }
 
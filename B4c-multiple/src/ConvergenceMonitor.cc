@@ -0,0 +1,215 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ConvergenceMonitor.cc
+/// \brief Implementation of the B4::ConvergenceMonitor class
+
+#include "ConvergenceMonitor.hh"
+
+#include "G4UnitsTable.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace B4
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ConvergenceMonitor::ConvergenceMonitor()
+ : fObservables{ kIonYield }
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ConvergenceMonitor::SetObservables(const G4String& names)
+{
+  // The selection is kept unless all names are known
+  std::vector<G4int> observables;
+  std::istringstream is(names);
+  G4String name;
+  while ( is >> name ) {
+    G4int observable = 0;
+    while ( observable < kNofObservables && name != GetName(observable) ) {
+      ++observable;
+    }
+    if ( observable == kNofObservables ) {
+      G4ExceptionDescription msg;
+      msg << "Unknown observable <" << name << ">, expected one of:";
+      for ( G4int i = 0; i < kNofObservables; ++i ) msg << " " << GetName(i);
+      msg << G4endl << "The observables are not changed.";
+      G4Exception("ConvergenceMonitor::SetObservables()",
+        "MyCode0020", JustWarning, msg);
+      return;
+    }
+    observables.push_back(observable);
+  }
+
+  if ( observables.empty() ) {
+    G4ExceptionDescription msg;
+    msg << "No observable given, the observables are not changed.";
+    G4Exception("ConvergenceMonitor::SetObservables()",
+      "MyCode0020", JustWarning, msg);
+    return;
+  }
+  fObservables = observables;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ConvergenceMonitor::BeginOfRun()
+{
+  for ( auto& sums : fObservableSums ) sums.Reset();
+  fNofEvents = 0;
+  fNextReport = fReportInterval;
+  fConverged = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ConvergenceMonitor::AddEvent(G4double edep, G4double ionYield, G4double weight)
+{
+  // Weighted events enter as weight * observable, whose mean is the
+  // unbiased estimate of the analog mean
+  const G4double values[kNofObservables]
+    = { weight * edep, weight * ionYield,
+        edep > 0. ? weight : 0., std::clamp(ionYield - 1., 0., 1.) * weight };
+
+  for ( G4int i = 0; i < kNofObservables; ++i ) {
+    fObservableSums[i].Fill(values[i]);
+  }
+
+  // Whichever thread adds the last event of a batch checks
+  if ( ( fNofEvents.fetch_add(1, std::memory_order_relaxed) + 1 ) % kBatchSize == 0 ) {
+    Check();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ConvergenceMonitor::Check()
+{
+  if ( ! IsEnabled() ) return;
+
+  auto snapshots = GetSnapshots();
+  auto nofEvents = snapshots[kEdep].nofEntries;
+
+  // Only the thread which moves the next report prints
+  auto next = fNextReport.load(std::memory_order_relaxed);
+  if ( fReportInterval > 0 && nofEvents >= next ) {
+    auto following = next;
+    while ( following <= nofEvents ) following += fReportInterval;
+    if ( fNextReport.compare_exchange_strong(next, following) ) {
+      PrintStatus(snapshots);
+    }
+  }
+
+  // Without an observable nothing can converge
+  if ( fConverged || fObservables.empty() || nofEvents < fMinEvents ) return;
+
+  for ( auto observable : fObservables ) {
+    if ( RelativeError(snapshots[observable]) > fTargetPrecision ) return;
+  }
+  if ( ! fConverged.exchange(true) ) {
+    G4cout << "---> Target precision " << fTargetPrecision
+           << " reached after " << nofEvents << " events" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ConvergenceMonitor::Report() const
+{
+  G4cout << G4endl << " ----> convergence for the entire run";
+  if ( fConverged ) G4cout << " (stopped at target precision)";
+  G4cout << G4endl;
+  PrintStatus(GetSnapshots());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ConvergenceMonitor::Snapshots ConvergenceMonitor::GetSnapshots() const
+{
+  Snapshots snapshots;
+  for ( G4int i = 0; i < kNofObservables; ++i ) {
+    snapshots[i] = fObservableSums[i].GetSnapshot();
+  }
+  return snapshots;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ConvergenceMonitor::RelativeError(const ConcurrentHistogram::Snapshot& sums)
+{
+  // The observables are filled with unit weight, sum w x and sum w x^2
+  // are the sums of the observable and of its square
+  auto n = sums.nofEntries;
+  if ( n < 2 ) return std::numeric_limits<G4double>::infinity();
+
+  auto mean = sums.sumWX / n;
+  if ( mean == 0. ) return std::numeric_limits<G4double>::infinity();
+
+  auto variance = (sums.sumWX2 / n - mean * mean) * n / (n - 1);
+  if ( variance < 0. ) variance = 0.;
+  return std::sqrt(variance / n) / std::abs(mean);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const char* ConvergenceMonitor::GetName(G4int observable)
+{
+  static const char* names[kNofObservables]
+    = { "edep", "ionYield", "hitFraction", "F2" };
+  return names[observable];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ConvergenceMonitor::PrintStatus(const Snapshots& snapshots) const
+{
+  if ( snapshots[kEdep].nofEntries == 0 ) return;
+
+  std::ostringstream os;
+  os << "---> " << snapshots[kEdep].nofEntries << " events:";
+  for ( G4int i = 0; i < kNofObservables; ++i ) {
+    auto mean = snapshots[i].GetMean();
+    os << "  " << GetName(i) << " = ";
+    if ( i == kEdep ) os << G4BestUnit(mean, "Energy");
+    else              os << mean;
+    os << " (" << 100. * RelativeError(snapshots[i]) << " %)";
+  }
+  if ( IsEnabled() ) {
+    os << "  target " << 100. * fTargetPrecision << " %";
+  }
+  G4cout << os.str() << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
@@ -28,28 +28,45 @@
 /// \brief Implementation of the B4c::DetectorConstruction class
 
 #include "DetectorConstruction.hh"
+#include "DetectorMessenger.hh"
+#include "NanoparticleGridParameterisation.hh"
 #include "CalorimeterSD.hh"
+#include "ImportanceBiasingOperator.hh"
+#include "ProtonTransportModel.hh"
 #include "G4Material.hh"
 #include "G4NistManager.hh"
 
 #include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
 #include "G4PVPlacement.hh"
 #include "G4PVReplica.hh"
+#include "G4PVParameterised.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4UserLimits.hh"
 #include "G4GlobalMagFieldMessenger.hh"
 #include "G4AutoDelete.hh"
 
 #include "G4SDManager.hh"
+#include "G4Threading.hh"
 
 #include "G4VisAttributes.hh"
 #include "G4Colour.hh"
 
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
 
 #include "G4Tubs.hh"
 #include "G4Sphere.hh"
 #include "G4Box.hh"
 
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
 
 namespace B4c
 {
@@ -62,13 +79,123 @@ G4GlobalMagFieldMessenger* DetectorConstruction::fMagFieldMessenger = nullptr;
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 DetectorConstruction::DetectorConstruction()
+ : fGridPitch(200 * nm),
+   fGridPosition(0., 0., -4.99 * cm),
+   fRegionMargin(1 * um),
+   fRegionCut(0.1 * nm),
+   fShellThickness(2 * um),
+   fFastSimMinEnergy(10 * MeV)
 {
+  fMessenger = new DetectorMessenger(this);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 DetectorConstruction::~DetectorConstruction()
 {
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetGridCounts(G4int nx, G4int ny, G4int nz)
+{
+  fGridNx = nx;
+  fGridNy = ny;
+  fGridNz = nz;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetGridPitch(G4double pitch)
+{
+  fGridPitch = pitch;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetGridPosition(const G4ThreeVector& position)
+{
+  fGridPosition = position;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetRegionMargin(G4double margin)
+{
+  fRegionMargin = margin;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetRegionCut(G4double cut)
+{
+  fRegionCut = cut;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetVerboseLevel(G4int level)
+{
+  fVerboseLevel = level;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetNofShells(G4int nofShells)
+{
+  fNofShells = nofShells;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetShellThickness(G4double thickness)
+{
+  fShellThickness = thickness;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetSplittingFactor(G4double factor)
+{
+  fSplittingFactor = factor;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetEnvelopeLength(G4double length)
+{
+  fEnvelopeLength = length;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetFastSimMinEnergy(G4double energy)
+{
+  fFastSimMinEnergy = energy;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetMaxStep(const G4String& volume, G4double maxStep)
+{
+  fVolumeLimits[volume].fMaxStep = maxStep;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetMaxTrackLength(const G4String& volume,
+                                             G4double maxTrackLength)
+{
+  fVolumeLimits[volume].fMaxTrackLength = maxTrackLength;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetMinKineticEnergy(const G4String& volume,
+                                               G4double minKineticEnergy)
+{
+  fVolumeLimits[volume].fMinKineticEnergy = minKineticEnergy;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -91,8 +218,10 @@ void DetectorConstruction::DefineMaterials()
   nistManager->FindOrBuildMaterial("G4_WATER");
   nistManager->FindOrBuildMaterial("G4_LITHIUM_FLUORIDE");
 
-  // Print materials
-  G4cout << *(G4Material::GetMaterialTable()) << G4endl;
+  // Print materials (/microyz/det/verbose 1)
+  if ( fVerboseLevel > 0 ) {
+    G4cout << *(G4Material::GetMaterialTable()) << G4endl;
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -190,48 +319,218 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
 			"SensitiveDetector");	// its name
 
 
-  // Coordinates for the center of SD arrangement
-  G4double center_x = 0 * nm;
-  G4double center_y = 0 * nm;
-  G4double center_z = - 4.99 * cm; // -worldHeight/2 + 6 * cm;
+  // Coordinates for the center of SD arrangement (/microyz/det/gridPosition)
+  G4double center_x = fGridPosition.x();
+  G4double center_y = fGridPosition.y();
+  G4double center_z = fGridPosition.z(); // default -4.99 cm, 100 um downstream of the source
 
-  // Amount of SDs in each direction - only odd numbers allowed!
-  int num_SDs_x = 11;
-  int num_SDs_y = 11;
-  int num_SDs_z = 11;
+  // Amount of SDs in each direction and distance between SDs
+  // (set via /microyz/det/gridCounts and /microyz/det/gridPitch)
+  fNofSDs = fGridNx * fGridNy * fGridNz;
 
-  G4cout << "Amount of Sensitive Detectors: " << num_SDs_x * num_SDs_y * num_SDs_z << G4endl;
+  G4cout << "Amount of Sensitive Detectors: " << fNofSDs
+         << " (" << fGridNx << " x " << fGridNy << " x " << fGridNz
+         << ", pitch " << G4BestUnit(fGridPitch, "Length") << ")" << G4endl;
 
-  // Distance between SDs
-  G4double distance = 200 * nm;
+  if ( fGridPitch < SD_sizeX || fGridPitch < SD_sizeY || fGridPitch < SD_sizeZ ) {
+    G4ExceptionDescription msg;
+    msg << "Grid pitch " << G4BestUnit(fGridPitch, "Length")
+        << " is smaller than the nanoparticle size.";
+    G4Exception("DetectorConstruction::DefineVolumes()",
+      "MyCode0007", FatalException, msg);
+  }
 
-  // Helper values for for-loop, since world-volume is centered at 0,0,0
-  G4double half_length_x = (num_SDs_x - 1)/2 * distance;
-  G4double half_length_y = (num_SDs_y - 1)/2 * distance;
-  G4double half_length_z = (num_SDs_z - 1)/2 * distance;
+  //
+  // Grid container
+  //
+  // Water box holding only the nanoparticles, one pitch per nanoparticle,
+  // so the navigator voxelises the lattice instead of scanning the world's
+  // daughter list.
+  // It is extended by the region margin (/microyz/det/regionMargin), as far
+  // as the world allows, and serves as root of the Nanodosimetry region.
+  G4double grid_hx = fGridNx * fGridPitch/2 + fRegionMargin;
+  G4double grid_hy = fGridNy * fGridPitch/2 + fRegionMargin;
+  G4double grid_hz = fGridNz * fGridPitch/2 + fRegionMargin;
+  const G4double limit_hx = worldRadius/std::sqrt(2.) - std::abs(center_x);
+  const G4double limit_hy = worldRadius/std::sqrt(2.) - std::abs(center_y);
+  const G4double limit_hz = worldHeight/2 - std::abs(center_z);
+  grid_hx = std::min(grid_hx, limit_hx);
+  grid_hy = std::min(grid_hy, limit_hy);
+  grid_hz = std::min(grid_hz, limit_hz);
+
+  auto gridS
+	= new G4Box("NanoparticleGrid",		// its name
+			grid_hx,			// its half length in X
+			grid_hy,			// its half length in Y
+			grid_hz);			// its half length in Z
+
+  auto gridLV
+	= new G4LogicalVolume(
+			gridS,			// its solid
+			worldMaterial,		// its material
+			"NanoparticleGrid");	// its name
+
+  //
+  // Importance shells
+  //
+  // Nested water boxes around the grid container, each one shell thickness
+  // (/microyz/biasing/shellThickness) larger. ImportanceShell1 is the
+  // innermost one, the grid container is placed in it and the outermost
+  // shell in the world.
+  // Only the shells which fit strictly inside the world are built: a shell
+  // clamped to the world would share its faces with the world or with the
+  // next shell, and the importance would change on coincident surfaces.
+  fNofShellsBuilt = 0;
+  while ( fNofShellsBuilt < fNofShells ) {
+    G4double extent = (fNofShellsBuilt + 1) * fShellThickness;
+    if ( grid_hx + extent >= limit_hx || grid_hy + extent >= limit_hy
+         || grid_hz + extent >= limit_hz ) break;
+    ++fNofShellsBuilt;
+  }
+  if ( fNofShellsBuilt < fNofShells ) {
+    G4ExceptionDescription msg;
+    msg << "Only " << fNofShellsBuilt << " of " << fNofShells
+        << " importance shells of " << G4BestUnit(fShellThickness, "Length")
+        << " fit into the world around the grid container,"
+        << " the outer ones are not built.";
+    G4Exception("DetectorConstruction::DefineVolumes()",
+      "MyCode0018", JustWarning, msg);
+  }
+
+  auto motherLV = worldLV;
+  auto motherPosition = G4ThreeVector(center_x, center_y, center_z);
+  G4double outer_hz = grid_hz;
+  for ( G4int shell = fNofShellsBuilt; shell >= 1; --shell ) {
+    auto name = "ImportanceShell" + std::to_string(shell);
+    G4double shell_hx = grid_hx + shell * fShellThickness;
+    G4double shell_hy = grid_hy + shell * fShellThickness;
+    G4double shell_hz = grid_hz + shell * fShellThickness;
+
+    auto shellS = new G4Box(name, shell_hx, shell_hy, shell_hz);
+    auto shellLV = new G4LogicalVolume(shellS, worldMaterial, name);
+    new G4PVPlacement(0, motherPosition, shellLV, name, motherLV,
+                      false, 0, fCheckOverlaps);
+
+    motherLV = shellLV;
+    motherPosition = G4ThreeVector();
+    outer_hz = std::max(outer_hz, shell_hz);
+  }
+
+  new G4PVPlacement(
+			0,						// its rotation
+			motherPosition,					// its placement
+			gridLV,						// its logical volume
+			"NanoparticleGrid",				// its name
+			motherLV,					// its mother volume
+			false,						// no boolean operation
+			0,						// copy number
+			fCheckOverlaps);				// checking overlaps
 
   // Placing the SDs
-  for (G4double i = center_x - half_length_x; i <= center_x + half_length_x; i += distance){
-    for (G4double j = center_y - half_length_y; j <= center_y + half_length_y; j += distance){
-      for (G4double k = center_z - half_length_z; k <= center_z + half_length_z; k += distance){
-        new G4PVPlacement(
-	   		0, 				// its rotation
-			G4ThreeVector(i, j, k),		// its placement
-			SensitiveDetectorLV,		// its logical volume
+  // Each SD gets a unique copy number ix + nx*(iy + ny*iz)
+  auto gridParam
+    = new NanoparticleGridParameterisation(fGridNx, fGridNy, fGridNz, fGridPitch);
+
+  // Checking overlaps samples every copy, skip it for very large lattices
+  const G4int maxCheckedCopies = 1331;
+
+  new G4PVParameterised(
 			"SensitiveDetector",		// its name
-			worldLV,			// its mother volume
-			false,				// no boolean operation
-			0,				// copy number
-			fCheckOverlaps);		// checking overlaps
-      }
+			SensitiveDetectorLV,		// its logical volume
+			gridLV,				// its mother volume
+			kUndefined,			// 3D voxelisation of the copies
+			fNofSDs,			// number of copies
+			gridParam,			// its parameterisation
+			fCheckOverlaps && fNofSDs <= maxCheckedCopies);	// checking overlaps
+
+  //
+  // Transport envelope
+  //
+  // Water slab of the world cross-section from the upstream end of the
+  // world (/microyz/fastsim/envelopeLength), the TransportEnvelope region in
+  // which ProtonTransportModel moves the primary protons in one step. It
+  // ends before the grid container and its importance shells; delta
+  // electrons are not produced inside, ProtonTransportModel warns if the gap
+  // to the grid is shorter than their range.
+  fEnvelopeGap = 0.;
+  if ( fEnvelopeLength > 0. ) {
+    G4double envelopeLength = fEnvelopeLength;
+    G4double maxLength = center_z - outer_hz + worldHeight/2;
+    if ( envelopeLength > maxLength ) {
+      G4ExceptionDescription msg;
+      msg << "Transport envelope of " << G4BestUnit(envelopeLength, "Length")
+          << " overlaps the nanoparticle grid, it is shortened to "
+          << G4BestUnit(std::max(maxLength, 0.), "Length") << ".";
+      G4Exception("DetectorConstruction::DefineVolumes()",
+        "MyCode0015", JustWarning, msg);
+      envelopeLength = maxLength;
+    }
+
+    if ( envelopeLength > 0. ) {
+      auto envelopeS
+        = new G4Tubs("TransportEnvelope", 0, worldRadius, envelopeLength/2,
+                     0.*deg, 360.*deg);
+      auto envelopeLV
+        = new G4LogicalVolume(envelopeS, worldMaterial, "TransportEnvelope");
+      new G4PVPlacement(0, G4ThreeVector(0., 0., -worldHeight/2 + envelopeLength/2),
+                        envelopeLV, "TransportEnvelope", worldLV,
+                        false, 0, fCheckOverlaps);
+
+      auto envelopeRegion = new G4Region("TransportEnvelope");
+      envelopeLV->SetRegion(envelopeRegion);
+      envelopeRegion->AddRootLogicalVolume(envelopeLV);
+
+      G4cout << "Transport envelope: " << G4BestUnit(envelopeLength, "Length")
+             << ", gap to the grid "
+             << G4BestUnit(maxLength - envelopeLength, "Length") << G4endl;
+      fEnvelopeGap = maxLength - envelopeLength;
     }
   }
+
+  //
+  // Nanodosimetry region
+  //
+  // Geant4-DNA models are activated in this region by PhysicsList
+  // (/microyz/phys/dnaRegion), condensed-history physics is used elsewhere
+  auto nanodosimetryRegion = new G4Region("Nanodosimetry");
+  gridLV->SetRegion(nanodosimetryRegion);
+  nanodosimetryRegion->AddRootLogicalVolume(gridLV);
+
+  // Fine production cut only where we score, the world keeps /run/setCut
+  auto regionCuts = new G4ProductionCuts();
+  regionCuts->SetProductionCut(fRegionCut);
+  nanodosimetryRegion->SetProductionCuts(regionCuts);
+
+  G4cout << "Nanodosimetry region: " << G4BestUnit(2*grid_hx, "Length")
+         << " x " << G4BestUnit(2*grid_hy, "Length")
+         << " x " << G4BestUnit(2*grid_hz, "Length")
+         << ", cut " << G4BestUnit(fRegionCut, "Length") << G4endl;
+
   //
   // Visualization attributes
   //
  // worldLV->SetVisAttributes (G4VisAttributes::GetInvisible());
 
 
+  //
+  // User limits (/microyz/limits/ commands)
+  //
+  ApplyUserLimits();
+
+  // The importance shells and the transport envelope are part of the world
+  // as far as the physics is concerned, they get its limits unless they
+  // have their own
+  std::vector<G4String> worldParts = { "TransportEnvelope" };
+  for ( G4int shell = 1; shell <= fNofShellsBuilt; ++shell ) {
+    worldParts.push_back("ImportanceShell" + std::to_string(shell));
+  }
+  for ( const auto& name : worldParts ) {
+    auto partLV = G4LogicalVolumeStore::GetInstance()->GetVolume(name, false);
+    if ( partLV != nullptr && partLV->GetUserLimits() == nullptr ) {
+      partLV->SetUserLimits(worldLV->GetUserLimits());
+    }
+  }
+
   //
   // Always return the physical World
   //
@@ -240,6 +539,41 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void DetectorConstruction::ApplyUserLimits()
+{
+  // The limits only act on the particles with G4StepLimiter and
+  // G4UserSpecialCuts processes (electrons, see PhysicsList), they are not
+  // propagated to the daughter volumes
+  for ( const auto& [volume, limits] : fVolumeLimits ) {
+    auto logicalVolume = G4LogicalVolumeStore::GetInstance()->GetVolume(volume, false);
+    if ( logicalVolume == nullptr ) {
+      G4ExceptionDescription msg;
+      msg << "Logical volume " << volume << " not found, user limits ignored.";
+      G4Exception("DetectorConstruction::ApplyUserLimits()",
+        "MyCode0011", JustWarning, msg);
+      continue;
+    }
+
+    logicalVolume->SetUserLimits(
+      new G4UserLimits(limits.fMaxStep, limits.fMaxTrackLength, DBL_MAX,
+                       limits.fMinKineticEnergy));
+
+    G4cout << "User limits of " << volume << ":";
+    if ( limits.fMaxStep < DBL_MAX ) {
+      G4cout << " max step " << G4BestUnit(limits.fMaxStep, "Length");
+    }
+    if ( limits.fMaxTrackLength < DBL_MAX ) {
+      G4cout << " max track length " << G4BestUnit(limits.fMaxTrackLength, "Length");
+    }
+    if ( limits.fMinKineticEnergy > 0. ) {
+      G4cout << " min kinetic energy " << G4BestUnit(limits.fMinKineticEnergy, "Energy");
+    }
+    G4cout << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void DetectorConstruction::ConstructSDandField()
 {
   // G4SDManager::GetSDMpointer()->SetVerboseLevel(1);
@@ -251,10 +585,48 @@ void DetectorConstruction::ConstructSDandField()
   auto SensitiveDetector = new CalorimeterSD(					// create new sensitive detector
 				"SensitiveDetector",				// its name
 				"SensitiveDetectorHitsCollection",		// name of hit collection --> where recorded interactions are stored
-				1);						// no. of cells (layers)
+				fNofSDs);					// no. of cells (nanoparticles)
   G4SDManager::GetSDMpointer()->AddNewDetector(SensitiveDetector); 		// register the SD in Geant4's SD manager
   SetSensitiveDetector("SensitiveDetector", SensitiveDetector);			// assign sensitive detector to the logical volume
 
+  //
+  // Importance biasing
+  //
+  // The importance is multiplied by the splitting factor at each shell
+  // boundary and at the boundary of the grid container. The nanoparticles
+  // have no importance of their own, entering them does not split.
+  if ( fNofShellsBuilt > 0 ) {
+    auto lvStore = G4LogicalVolumeStore::GetInstance();
+    auto biasingOperator = new ImportanceBiasingOperator("ImportanceBiasing");
+    G4double importance = 1.;
+    biasingOperator->SetImportance(lvStore->GetVolume("World"), importance);
+    for ( G4int shell = fNofShellsBuilt; shell >= 1; --shell ) {
+      importance *= fSplittingFactor;
+      biasingOperator->SetImportance(
+        lvStore->GetVolume("ImportanceShell" + std::to_string(shell)), importance);
+    }
+    importance *= fSplittingFactor;
+    biasingOperator->SetImportance(lvStore->GetVolume("NanoparticleGrid"), importance);
+
+    if ( G4Threading::G4GetThreadId() <= 0 ) {
+      G4cout << "Importance biasing: " << fNofShellsBuilt << " shells of "
+             << G4BestUnit(fShellThickness, "Length") << ", splitting factor "
+             << fSplittingFactor << ", importance in the grid " << importance
+             << G4endl;
+    }
+  }
+
+  //
+  // Fast proton transport
+  //
+  auto envelopeRegion
+    = G4RegionStore::GetInstance()->GetRegion("TransportEnvelope", false);
+  if ( envelopeRegion != nullptr ) {
+    auto protonTransport = new ProtonTransportModel("ProtonTransport", envelopeRegion);
+    protonTransport->SetMinEnergy(fFastSimMinEnergy);
+    protonTransport->SetGap(fEnvelopeGap);
+  }
+
   //
   // Magnetic field
   //
@@ -0,0 +1,313 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file DetectorMessenger.cc
+/// \brief Implementation of the B4c::DetectorMessenger class
+
+#include "DetectorMessenger.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UnitsTable.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWith3VectorAndUnit.hh"
+
+#include <sstream>
+
+namespace B4c
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+DetectorMessenger::DetectorMessenger(DetectorConstruction* detConstruction)
+ : fDetConstruction(detConstruction)
+{
+  fDetDir = new G4UIdirectory("/microyz/det/");
+  fDetDir->SetGuidance("detector construction commands");
+
+  fGridCountsCmd = new G4UIcommand("/microyz/det/gridCounts", this);
+  fGridCountsCmd->SetGuidance("Number of nanoparticles along x, y and z.");
+  for ( auto axis : { "nx", "ny", "nz" } ) {
+    auto param = new G4UIparameter(axis, 'i', false);
+    param->SetParameterRange(G4String(axis) + " >= 1");
+    fGridCountsCmd->SetParameter(param);
+  }
+  fGridCountsCmd->AvailableForStates(G4State_PreInit);
+  fGridCountsCmd->SetToBeBroadcasted(false);
+
+  fGridPitchCmd = new G4UIcmdWithADoubleAndUnit("/microyz/det/gridPitch", this);
+  fGridPitchCmd->SetGuidance("Centre-to-centre distance of the nanoparticles.");
+  fGridPitchCmd->SetParameterName("pitch", false);
+  fGridPitchCmd->SetRange("pitch > 0.");
+  fGridPitchCmd->SetUnitCategory("Length");
+  fGridPitchCmd->SetDefaultUnit("nm");
+  fGridPitchCmd->AvailableForStates(G4State_PreInit);
+  fGridPitchCmd->SetToBeBroadcasted(false);
+
+  fGridPositionCmd = new G4UIcmdWith3VectorAndUnit("/microyz/det/gridPosition", this);
+  fGridPositionCmd->SetGuidance("Centre of the nanoparticle grid (world centre at 0 0 0,");
+  fGridPositionCmd->SetGuidance("upstream end of the world at z = -5 cm).");
+  fGridPositionCmd->SetParameterName("x", "y", "z", false);
+  fGridPositionCmd->SetUnitCategory("Length");
+  fGridPositionCmd->SetDefaultUnit("cm");
+  fGridPositionCmd->AvailableForStates(G4State_PreInit);
+  fGridPositionCmd->SetToBeBroadcasted(false);
+
+  fRegionMarginCmd = new G4UIcmdWithADoubleAndUnit("/microyz/det/regionMargin", this);
+  fRegionMarginCmd->SetGuidance("Margin of the Nanodosimetry region around the sensitive detectors.");
+  fRegionMarginCmd->SetParameterName("margin", false);
+  fRegionMarginCmd->SetRange("margin >= 0.");
+  fRegionMarginCmd->SetUnitCategory("Length");
+  fRegionMarginCmd->SetDefaultUnit("um");
+  fRegionMarginCmd->AvailableForStates(G4State_PreInit);
+  fRegionMarginCmd->SetToBeBroadcasted(false);
+
+  fRegionCutCmd = new G4UIcmdWithADoubleAndUnit("/microyz/det/regionCut", this);
+  fRegionCutCmd->SetGuidance("Production cut (all particles) in the Nanodosimetry region.");
+  fRegionCutCmd->SetGuidance("The rest of the world uses /run/setCut.");
+  fRegionCutCmd->SetParameterName("cut", false);
+  fRegionCutCmd->SetRange("cut > 0.");
+  fRegionCutCmd->SetUnitCategory("Length");
+  fRegionCutCmd->SetDefaultUnit("nm");
+  fRegionCutCmd->AvailableForStates(G4State_PreInit);
+  fRegionCutCmd->SetToBeBroadcasted(false);
+
+  fVerboseCmd = new G4UIcmdWithAnInteger("/microyz/det/verbose", this);
+  fVerboseCmd->SetGuidance("Verbose level of the detector construction,");
+  fVerboseCmd->SetGuidance(">= 1 prints the material table.");
+  fVerboseCmd->SetParameterName("level", false);
+  fVerboseCmd->SetRange("level >= 0");
+  fVerboseCmd->AvailableForStates(G4State_PreInit);
+  fVerboseCmd->SetToBeBroadcasted(false);
+
+  fLimitsDir = new G4UIdirectory("/microyz/limits/");
+  fLimitsDir->SetGuidance("user limits of logical volumes, applied to electrons");
+  fLimitsDir->SetGuidance("(G4StepLimiter, G4UserSpecialCuts); not inherited by daughters");
+
+  fMaxStepCmd = MakeLimitCommand("/microyz/limits/maxStep",
+    "Maximum step length in a logical volume.", "value > 0.", "nm");
+  fMaxTrackLengthCmd = MakeLimitCommand("/microyz/limits/maxTrackLength",
+    "Maximum track length in a logical volume.", "value > 0.", "um");
+  fMinKineticEnergyCmd = MakeLimitCommand("/microyz/limits/minEkin",
+    "Tracks below this kinetic energy are killed (energy deposited locally).",
+    "value >= 0.", "eV");
+
+  fBiasingDir = new G4UIdirectory("/microyz/biasing/");
+  fBiasingDir->SetGuidance("importance splitting / Russian roulette around the grid");
+  fBiasingDir->SetGuidance("(particles selected with /microyz/phys/biasing)");
+
+  fNofShellsCmd = new G4UIcmdWithAnInteger("/microyz/biasing/shells", this);
+  fNofShellsCmd->SetGuidance("Number of importance shells around the grid container,");
+  fNofShellsCmd->SetGuidance("0 disables the biasing.");
+  fNofShellsCmd->SetParameterName("nofShells", false);
+  fNofShellsCmd->SetRange("nofShells >= 0");
+  fNofShellsCmd->AvailableForStates(G4State_PreInit);
+  fNofShellsCmd->SetToBeBroadcasted(false);
+
+  fShellThicknessCmd = new G4UIcmdWithADoubleAndUnit("/microyz/biasing/shellThickness", this);
+  fShellThicknessCmd->SetGuidance("Thickness of the importance shells.");
+  fShellThicknessCmd->SetParameterName("thickness", false);
+  fShellThicknessCmd->SetRange("thickness > 0.");
+  fShellThicknessCmd->SetUnitCategory("Length");
+  fShellThicknessCmd->SetDefaultUnit("um");
+  fShellThicknessCmd->AvailableForStates(G4State_PreInit);
+  fShellThicknessCmd->SetToBeBroadcasted(false);
+
+  fSplittingFactorCmd = new G4UIcmdWithADouble("/microyz/biasing/splittingFactor", this);
+  fSplittingFactorCmd->SetGuidance("Importance ratio of neighbouring shells: number of copies");
+  fSplittingFactorCmd->SetGuidance("of a track moving inwards, inverse survival probability");
+  fSplittingFactorCmd->SetGuidance("of a track moving outwards.");
+  fSplittingFactorCmd->SetParameterName("factor", false);
+  fSplittingFactorCmd->SetRange("factor > 1.");
+  fSplittingFactorCmd->AvailableForStates(G4State_PreInit);
+  fSplittingFactorCmd->SetToBeBroadcasted(false);
+
+  fFastSimDir = new G4UIdirectory("/microyz/fastsim/");
+  fFastSimDir->SetGuidance("fast transport of the primary protons upstream of the grid");
+  fFastSimDir->SetGuidance("(requires /microyz/phys/fastSimulation proton)");
+
+  fEnvelopeLengthCmd = new G4UIcmdWithADoubleAndUnit("/microyz/fastsim/envelopeLength", this);
+  fEnvelopeLengthCmd->SetGuidance("Length of the transport envelope from the upstream end of");
+  fEnvelopeLengthCmd->SetGuidance("the world, 0 disables the fast transport.");
+  fEnvelopeLengthCmd->SetGuidance("No delta electrons are produced inside, leave a gap to the grid.");
+  fEnvelopeLengthCmd->SetGuidance("A warning is issued if it is shorter than their CSDA range.");
+  fEnvelopeLengthCmd->SetParameterName("length", false);
+  fEnvelopeLengthCmd->SetRange("length >= 0.");
+  fEnvelopeLengthCmd->SetUnitCategory("Length");
+  fEnvelopeLengthCmd->SetDefaultUnit("mm");
+  fEnvelopeLengthCmd->AvailableForStates(G4State_PreInit);
+  fEnvelopeLengthCmd->SetToBeBroadcasted(false);
+
+  fFastSimMinEnergyCmd = new G4UIcmdWithADoubleAndUnit("/microyz/fastsim/minEnergy", this);
+  fFastSimMinEnergyCmd->SetGuidance("Protons are only moved in one step if their mean energy");
+  fFastSimMinEnergyCmd->SetGuidance("at the envelope exit is above this energy.");
+  fFastSimMinEnergyCmd->SetParameterName("energy", false);
+  fFastSimMinEnergyCmd->SetRange("energy > 0.");
+  fFastSimMinEnergyCmd->SetUnitCategory("Energy");
+  fFastSimMinEnergyCmd->SetDefaultUnit("MeV");
+  fFastSimMinEnergyCmd->AvailableForStates(G4State_PreInit);
+  fFastSimMinEnergyCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4UIcommand* DetectorMessenger::MakeLimitCommand(const char* path,
+                                                 const char* guidance,
+                                                 const char* range,
+                                                 const char* defaultUnit)
+{
+  auto command = new G4UIcommand(path, this);
+  command->SetGuidance(guidance);
+  command->SetGuidance("Parameters: logical volume name, value, unit.");
+
+  auto volumeParam = new G4UIparameter("volume", 's', false);
+  command->SetParameter(volumeParam);
+
+  auto valueParam = new G4UIparameter("value", 'd', false);
+  valueParam->SetParameterRange(range);
+  command->SetParameter(valueParam);
+
+  auto unitParam = new G4UIparameter("unit", 's', true);
+  unitParam->SetDefaultUnit(defaultUnit);
+  command->SetParameter(unitParam);
+
+  command->AvailableForStates(G4State_PreInit);
+  command->SetToBeBroadcasted(false);
+  return command;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+DetectorMessenger::~DetectorMessenger()
+{
+  delete fFastSimMinEnergyCmd;
+  delete fEnvelopeLengthCmd;
+  delete fFastSimDir;
+  delete fSplittingFactorCmd;
+  delete fShellThicknessCmd;
+  delete fNofShellsCmd;
+  delete fBiasingDir;
+  delete fMinKineticEnergyCmd;
+  delete fMaxTrackLengthCmd;
+  delete fMaxStepCmd;
+  delete fLimitsDir;
+  delete fVerboseCmd;
+  delete fRegionCutCmd;
+  delete fRegionMarginCmd;
+  delete fGridPositionCmd;
+  delete fGridPitchCmd;
+  delete fGridCountsCmd;
+  delete fDetDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fGridCountsCmd ) {
+    G4int nx = 1, ny = 1, nz = 1;
+    std::istringstream is(newValue);
+    is >> nx >> ny >> nz;
+    fDetConstruction->SetGridCounts(nx, ny, nz);
+  }
+  else if ( command == fGridPitchCmd ) {
+    fDetConstruction->SetGridPitch(
+      G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+  }
+  else if ( command == fGridPositionCmd ) {
+    fDetConstruction->SetGridPosition(
+      G4UIcmdWith3VectorAndUnit::GetNew3VectorValue(newValue));
+  }
+  else if ( command == fRegionMarginCmd ) {
+    fDetConstruction->SetRegionMargin(
+      G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+  }
+  else if ( command == fRegionCutCmd ) {
+    fDetConstruction->SetRegionCut(
+      G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+  }
+  else if ( command == fVerboseCmd ) {
+    fDetConstruction->SetVerboseLevel(
+      G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+  }
+  else if ( command == fNofShellsCmd ) {
+    fDetConstruction->SetNofShells(
+      G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+  }
+  else if ( command == fShellThicknessCmd ) {
+    fDetConstruction->SetShellThickness(
+      G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+  }
+  else if ( command == fSplittingFactorCmd ) {
+    fDetConstruction->SetSplittingFactor(
+      G4UIcmdWithADouble::GetNewDoubleValue(newValue));
+  }
+  else if ( command == fEnvelopeLengthCmd ) {
+    fDetConstruction->SetEnvelopeLength(
+      G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+  }
+  else if ( command == fFastSimMinEnergyCmd ) {
+    fDetConstruction->SetFastSimMinEnergy(
+      G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+  }
+  else if ( command == fMaxStepCmd || command == fMaxTrackLengthCmd
+            || command == fMinKineticEnergyCmd ) {
+    G4String volume, unit;
+    G4double value = 0.;
+    std::istringstream is(newValue);
+    is >> volume >> value >> unit;
+
+    // The unit parameter is a free string, reject a unit of another category
+    G4String category = ( command == fMinKineticEnergyCmd ) ? "Energy" : "Length";
+    if ( G4UnitDefinition::GetCategory(unit) != category ) {
+      G4ExceptionDescription msg;
+      msg << "Unit <" << unit << "> of " << command->GetCommandPath()
+          << " is not a unit of " << category << ", the limit of <"
+          << volume << "> is not set.";
+      G4Exception("DetectorMessenger::SetNewValue()",
+        "MyCode0021", JustWarning, msg);
+      return;
+    }
+    value *= G4UIcommand::ValueOf(unit);
+    if ( command == fMaxStepCmd ) {
+      fDetConstruction->SetMaxStep(volume, value);
+    }
+    else if ( command == fMaxTrackLengthCmd ) {
+      fDetConstruction->SetMaxTrackLength(volume, value);
+    }
+    else {
+      fDetConstruction->SetMinKineticEnergy(volume, value);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
@@ -0,0 +1,84 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ImportanceBiasingOperator.cc
+/// \brief Implementation of the B4c::ImportanceBiasingOperator class
+
+#include "ImportanceBiasingOperator.hh"
+#include "SplitOrRouletteOperation.hh"
+
+#include "G4LogicalVolume.hh"
+
+namespace B4c
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ImportanceBiasingOperator::ImportanceBiasingOperator(const G4String& name)
+ : G4VBiasingOperator(name)
+{
+  fSplitOrRouletteOperation = new SplitOrRouletteOperation("SplitOrRoulette", this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ImportanceBiasingOperator::~ImportanceBiasingOperator()
+{
+  delete fSplitOrRouletteOperation;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ImportanceBiasingOperator::SetImportance(const G4LogicalVolume* volume,
+                                              G4double importance)
+{
+  if ( fImportances.find(volume) == fImportances.end() ) {
+    AttachTo(volume);
+  }
+  fImportances[volume] = importance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ImportanceBiasingOperator::GetImportance(const G4LogicalVolume* volume) const
+{
+  auto it = fImportances.find(volume);
+  return ( it != fImportances.end() ) ? it->second : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VBiasingOperation* ImportanceBiasingOperator::ProposeNonPhysicsBiasingOperation(
+  const G4Track*, const G4BiasingProcessInterface*)
+{
+  // The operation decides at the end of each step whether a boundary
+  // between two importances has been crossed
+  return fSplitOrRouletteOperation;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
@@ -0,0 +1,138 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file IonisationClassifier.cc
+/// \brief Implementation of the B4::IonisationClassifier class
+
+#include "IonisationClassifier.hh"
+
+#include "G4Electron.hh"
+#include "G4ProcessTable.hh"
+#include "G4ProcessVector.hh"
+#include "G4VProcess.hh"
+
+#include <sstream>
+
+namespace B4
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+IonisationClassifier::IonisationClassifier()
+ : fPatterns{ "*Ioni*" }
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void IonisationClassifier::SetPatterns(const G4String& patterns)
+{
+  fPatterns.clear();
+  std::istringstream is(patterns);
+  G4String pattern;
+  while ( is >> pattern ) {
+    fPatterns.push_back(pattern);
+  }
+  fProcesses.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String IonisationClassifier::GetPatterns() const
+{
+  G4String patterns;
+  for ( const auto& pattern : fPatterns ) {
+    if ( ! patterns.empty() ) patterns += " ";
+    patterns += pattern;
+  }
+  return patterns;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void IonisationClassifier::Resolve()
+{
+  fElectron = G4Electron::Definition();
+  fProcesses.clear();
+
+  // All processes of this thread, the vector is owned by the caller
+  auto processes = G4ProcessTable::GetProcessTable()->FindProcesses();
+  std::vector<G4bool> used(fPatterns.size(), false);
+  for ( std::size_t i = 0; i < processes->size(); ++i ) {
+    const G4VProcess* process = (*processes)[i];
+    for ( std::size_t j = 0; j < fPatterns.size(); ++j ) {
+      if ( Match(fPatterns[j].c_str(), process->GetProcessName().c_str()) ) {
+        if ( std::find(fProcesses.begin(), fProcesses.end(), process)
+             == fProcesses.end() ) {
+          fProcesses.push_back(process);
+        }
+        used[j] = true;
+      }
+    }
+  }
+  delete processes;
+
+  for ( std::size_t j = 0; j < fPatterns.size(); ++j ) {
+    if ( ! used[j] ) {
+      G4ExceptionDescription msg;
+      msg << "No process matches \"" << fPatterns[j] << "\".";
+      G4Exception("IonisationClassifier::Resolve()",
+        "MyCode0008", JustWarning, msg);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool IonisationClassifier::Match(const char* pattern, const char* name)
+{
+  // Glob matching with '*', backtracking to the last star on mismatch
+  const char* star = nullptr;
+  const char* resume = nullptr;
+  while ( *name ) {
+    if ( *pattern == '*' ) {
+      star = pattern++;
+      resume = name;
+    }
+    else if ( *pattern == *name ) {
+      ++pattern;
+      ++name;
+    }
+    else if ( star ) {
+      pattern = star + 1;
+      name = ++resume;
+    }
+    else {
+      return false;
+    }
+  }
+  while ( *pattern == '*' ) ++pattern;
+  return *pattern == '\0';
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
@@ -0,0 +1,72 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file NanoparticleGridParameterisation.cc
+/// \brief Implementation of the B4c::NanoparticleGridParameterisation class
+
+#include "NanoparticleGridParameterisation.hh"
+
+#include "G4VPhysicalVolume.hh"
+#include "G4ThreeVector.hh"
+
+namespace B4c
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NanoparticleGridParameterisation::NanoparticleGridParameterisation(
+                                    G4int nx, G4int ny, G4int nz, G4double pitch)
+ : fNx(nx), fNy(ny), fNz(nz), fPitch(pitch)
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NanoparticleGridParameterisation::~NanoparticleGridParameterisation()
+{
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NanoparticleGridParameterisation::ComputeTransformation(
+                          const G4int copyNo, G4VPhysicalVolume* physVol) const
+{
+  G4int ix = copyNo % fNx;
+  G4int iy = (copyNo / fNx) % fNy;
+  G4int iz = copyNo / (fNx * fNy);
+
+  // Offsets from the centre of the grid container
+  G4double x = (ix - 0.5 * (fNx - 1)) * fPitch;
+  G4double y = (iy - 0.5 * (fNy - 1)) * fPitch;
+  G4double z = (iz - 0.5 * (fNz - 1)) * fPitch;
+
+  physVol->SetTranslation(G4ThreeVector(x, y, z));
+  physVol->SetRotation(nullptr);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
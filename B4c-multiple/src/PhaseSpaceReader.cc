@@ -0,0 +1,233 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhaseSpaceReader.cc
+/// \brief Implementation of the B4::PhaseSpaceReader class
+
+#include "PhaseSpaceReader.hh"
+#include "PhaseSpaceFormat.hh"
+#include "JobPartition.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Event.hh"
+#include "G4IonTable.hh"
+#include "G4ParticleTable.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <memory>
+#include <vector>
+
+namespace B4
+{
+
+/// Read-only mapping of a phase-space file with the offsets of its events
+struct PhaseSpaceReader::Mapping
+{
+  ~Mapping() { if ( data ) munmap(const_cast<char*>(data), size); }
+
+  const char* data = nullptr;
+  std::size_t size = 0;
+  PhaseSpaceFormat::Header header;
+  std::vector<std::size_t> eventOffsets; // one past the end at the back
+};
+
+}
+
+namespace
+{
+  G4Mutex mappingMutex = G4MUTEX_INITIALIZER;
+}
+
+namespace B4
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceReader::SetFileName(const G4String& fileName)
+{
+  fFileName = fileName;
+  fMapping = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const PhaseSpaceReader::Mapping* PhaseSpaceReader::Map(const G4String& fileName)
+{
+  // Files mapped by any thread, kept until the end of the program
+  static std::map<G4String, std::unique_ptr<Mapping>> mappings;
+
+  G4AutoLock lock(&mappingMutex);
+
+  auto& mapping = mappings[fileName];
+  if ( mapping ) return mapping.get();
+
+  auto fail = [&fileName](const char* reason) {
+    G4ExceptionDescription msg;
+    msg << "Cannot replay phase space " << fileName << ": " << reason;
+    G4Exception("PhaseSpaceReader::Map()", "MyCode0013", FatalException, msg);
+  };
+
+  auto fd = open(fileName.c_str(), O_RDONLY);
+  if ( fd < 0 ) {
+    fail("cannot open the file");
+    return nullptr;
+  }
+  struct stat status;
+  fstat(fd, &status);
+
+  auto newMapping = std::make_unique<Mapping>();
+  newMapping->size = status.st_size;
+  if ( newMapping->size >= PhaseSpaceFormat::kHeaderSize ) {
+    auto data = mmap(nullptr, newMapping->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if ( data != MAP_FAILED ) {
+      newMapping->data = static_cast<const char*>(data);
+      madvise(data, newMapping->size, MADV_SEQUENTIAL);
+    }
+  }
+  close(fd);
+
+  if ( newMapping->data == nullptr
+       || ! PhaseSpaceFormat::DecodeHeader(newMapping->data, newMapping->header) ) {
+    fail("not a phase-space file (or written with another format version or byte order)");
+    return nullptr;
+  }
+  auto recordsSize = newMapping->size - PhaseSpaceFormat::kHeaderSize;
+  if ( recordsSize % PhaseSpaceFormat::kRecordSize != 0 ) {
+    fail("truncated file");
+    return nullptr;
+  }
+
+  // Offsets of the first record of each source event
+  auto& offsets = newMapping->eventOffsets;
+  for ( auto offset = PhaseSpaceFormat::kHeaderSize; offset < newMapping->size;
+        offset += PhaseSpaceFormat::kRecordSize ) {
+    auto eventID = PhaseSpaceFormat::EventID(newMapping->data + offset);
+    if ( offsets.empty()
+         || eventID != PhaseSpaceFormat::EventID(newMapping->data + offsets.back()) ) {
+      offsets.push_back(offset);
+    }
+  }
+  if ( offsets.empty() ) {
+    fail("no particles in the file");
+    return nullptr;
+  }
+  offsets.push_back(newMapping->size);
+
+  G4cout << "Phase space " << fileName << ": "
+         << recordsSize / PhaseSpaceFormat::kRecordSize << " particles in "
+         << offsets.size() - 1 << " of " << newMapping->header.nofSourceEvents
+         << " source events, captured at z = "
+         << newMapping->header.planeZ << " mm" << G4endl;
+
+  mapping = std::move(newMapping);
+  return mapping.get();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4ParticleDefinition* PhaseSpaceReader::FindParticle(G4int pdg)
+{
+  auto it = fParticles.find(pdg);
+  if ( it != fParticles.end() ) return it->second;
+
+  const G4ParticleDefinition* particle
+    = G4ParticleTable::GetParticleTable()->FindParticle(pdg);
+  if ( particle == nullptr && pdg > 1000000000 ) {
+    particle = G4IonTable::GetIonTable()->GetIon(pdg);
+  }
+  if ( particle == nullptr ) {
+    G4ExceptionDescription msg;
+    msg << "Unknown PDG code " << pdg << " in the phase space, skipped.";
+    G4Exception("PhaseSpaceReader::FindParticle()",
+      "MyCode0013", JustWarning, msg);
+  }
+  fParticles[pdg] = particle;
+  return particle;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhaseSpaceReader::GeneratePrimaries(G4Event* event)
+{
+  if ( fMapping == nullptr ) {
+    fMapping = Map(fFileName);
+  }
+
+  const auto& offsets = fMapping->eventOffsets;
+  std::size_t nofEvents = offsets.size() - 1;
+  // The jobs of a partitioned run replay consecutive source events
+  std::size_t eventID = JobPartition::GetGlobalEventID(event->GetEventID());
+  if ( fNofPasses > 0 && eventID / nofEvents >= std::size_t(fNofPasses) ) {
+    return false;
+  }
+
+  auto sourceEvent = eventID % nofEvents;
+  G4double phi = fRandomRotation ? twopi * G4UniformRand() : 0.;
+
+  PhaseSpaceFormat::Record record;
+  for ( auto offset = offsets[sourceEvent]; offset < offsets[sourceEvent + 1];
+        offset += PhaseSpaceFormat::kRecordSize ) {
+    PhaseSpaceFormat::DecodeRecord(fMapping->data + offset, record);
+
+    auto particle = FindParticle(record.pdg);
+    if ( particle == nullptr ) continue;
+
+    G4ThreeVector position(record.position[0] * mm,
+                           record.position[1] * mm,
+                           record.position[2] * mm);
+    G4ThreeVector direction(record.direction[0],
+                            record.direction[1],
+                            record.direction[2]);
+    if ( phi != 0. ) {
+      position.rotateZ(phi);
+      direction.rotateZ(phi);
+    }
+    position += fShift;
+
+    auto primary = new G4PrimaryParticle(particle);
+    primary->SetKineticEnergy(record.energy * MeV);
+    primary->SetMomentumDirection(direction.unit());
+
+    auto vertex = new G4PrimaryVertex(position, 0.);
+    vertex->SetWeight(record.weight);
+    vertex->SetPrimary(primary);
+    event->AddPrimaryVertex(vertex);
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
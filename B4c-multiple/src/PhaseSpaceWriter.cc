@@ -0,0 +1,163 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhaseSpaceWriter.cc
+/// \brief Implementation of the B4::PhaseSpaceWriter class
+
+#include "PhaseSpaceWriter.hh"
+#include "PhaseSpaceFormat.hh"
+
+#include "G4ParticleDefinition.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace B4
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceWriter::Open()
+{
+  fShard.Open(fFileName);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceWriter::Close()
+{
+  fShard.Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceWriter::Write(const G4Step* step, G4long eventID)
+{
+  auto preStepPoint = step->GetPreStepPoint();
+  auto postStepPoint = step->GetPostStepPoint();
+
+  // Crossing point on the straight step
+  const auto& pre = preStepPoint->GetPosition();
+  const auto& post = postStepPoint->GetPosition();
+  G4double fraction = (fPlaneZ - pre.z()) / (post.z() - pre.z());
+  G4ThreeVector position = pre + fraction * (post - pre);
+  position.setZ(fPlaneZ);
+
+  auto track = step->GetTrack();
+  PhaseSpaceFormat::Record record;
+  record.eventID = eventID;
+  record.pdg = track->GetDefinition()->GetPDGEncoding();
+  record.energy = postStepPoint->GetKineticEnergy() / MeV;
+  for ( G4int i = 0; i < 3; ++i ) {
+    record.position[i] = position[i] / mm;
+    record.direction[i] = postStepPoint->GetMomentumDirection()[i];
+  }
+  record.weight = track->GetWeight();
+
+  char data[PhaseSpaceFormat::kRecordSize];
+  PhaseSpaceFormat::EncodeRecord(data, record);
+  fShard.Write(data, sizeof(data));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceWriter::Merge(G4long nofSourceEvents) const
+{
+  using PhaseSpaceFormat::kRecordSize;
+
+  auto shards = OutputShard::TakeShards(fFileName);
+
+  std::ofstream outFile(fFileName, std::ios::trunc | std::ios::binary);
+  if ( ! outFile.is_open() ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open " << fFileName << " for merging";
+    G4Exception("PhaseSpaceWriter::Merge()", "MyCode0012", JustWarning, msg);
+    return;
+  }
+  auto header = PhaseSpaceFormat::EncodeHeader(nofSourceEvents, fPlaneZ / mm);
+  outFile.write(header.data(), header.size());
+
+  // One read cursor per shard, positioned on its next record
+  struct Cursor {
+    std::ifstream in;
+    char record[kRecordSize];
+    std::int64_t eventID = 0;
+  };
+  auto next = [](Cursor& cursor) {
+    if ( ! cursor.in.read(cursor.record, kRecordSize) ) return false;
+    cursor.eventID = PhaseSpaceFormat::EventID(cursor.record);
+    return true;
+  };
+
+  // k-way merge on (event ID, shard index), as for the text shards
+  using Entry = std::pair<std::int64_t, std::size_t>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+  std::vector<std::unique_ptr<Cursor>> cursors;
+  for ( const auto& shard : shards ) {
+    auto cursor = std::make_unique<Cursor>();
+    cursor->in.open(shard, std::ios::binary);
+    if ( next(*cursor) ) queue.emplace(cursor->eventID, cursors.size());
+    cursors.push_back(std::move(cursor));
+  }
+
+  G4long nofRecords = 0;
+  while ( ! queue.empty() ) {
+    auto index = queue.top().second;
+    queue.pop();
+
+    auto& cursor = *cursors[index];
+    auto eventID = cursor.eventID;
+    G4bool more = false;
+    do {
+      outFile.write(cursor.record, kRecordSize);
+      ++nofRecords;
+      more = next(cursor);
+    } while ( more && cursor.eventID == eventID );
+
+    if ( more ) queue.emplace(cursor.eventID, index);
+  }
+
+  // Remove the merged shards
+  cursors.clear();
+  for ( const auto& shard : shards ) {
+    std::remove(shard.c_str());
+  }
+
+  G4cout << "Phase space " << fFileName << ": " << nofRecords
+         << " particles of " << nofSourceEvents << " events" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
@@ -43,7 +43,8 @@
 
 PhysicsListMessenger::PhysicsListMessenger(PhysicsList* pPhys)
 :G4UImessenger(),fPhysicsList(pPhys),
- fPhysDir(0), fListCmd(0)
+ fPhysDir(0), fListCmd(0), fDnaRegionCmd(0), fTableCacheCmd(0), fBiasingCmd(0),
+ fFastSimulationCmd(0)
 {
   fPhysDir = new G4UIdirectory("/microyz/phys/");
   fPhysDir->SetGuidance("physics list commands");
@@ -53,12 +54,47 @@ PhysicsListMessenger::PhysicsListMessenger(PhysicsList* pPhys)
   fListCmd->SetParameterName("PList",false);
   fListCmd->AvailableForStates(G4State_PreInit);
   fListCmd->SetToBeBroadcasted(false);        
+
+  fDnaRegionCmd = new G4UIcmdWithAString("/microyz/phys/dnaRegion",this);  
+  fDnaRegionCmd->SetGuidance("Use Geant4-DNA models inside the Nanodosimetry region");
+  fDnaRegionCmd->SetGuidance("around the sensitive detectors (/microyz/det/regionMargin),");
+  fDnaRegionCmd->SetGuidance("on top of a condensed-history list, e.g. emStd4_hadCustom.");
+  fDnaRegionCmd->SetParameterName("option",false);
+  fDnaRegionCmd->SetCandidates("none DNA_Opt0 DNA_Opt2 DNA_Opt4 DNA_Opt6 DNA_Opt7");
+  fDnaRegionCmd->AvailableForStates(G4State_PreInit);
+  fDnaRegionCmd->SetToBeBroadcasted(false);        
+
+  fTableCacheCmd = new G4UIcmdWithAString("/microyz/phys/tableCache",this);  
+  fTableCacheCmd->SetGuidance("Directory in which the physics tables of the first run are");
+  fTableCacheCmd->SetGuidance("stored, keyed by physics list, cuts and materials, and from");
+  fTableCacheCmd->SetGuidance("which later jobs retrieve them; none disables the cache.");
+  fTableCacheCmd->SetParameterName("directory",false);
+  fTableCacheCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fTableCacheCmd->SetToBeBroadcasted(false);        
+
+  fBiasingCmd = new G4UIcmdWithAString("/microyz/phys/biasing",this);  
+  fBiasingCmd->SetGuidance("Particles split / killed at the importance shells");
+  fBiasingCmd->SetGuidance("(/microyz/biasing/), e.g. \"e-\" or \"e- gamma\"; none disables it.");
+  fBiasingCmd->SetParameterName("particles",false);
+  fBiasingCmd->AvailableForStates(G4State_PreInit);
+  fBiasingCmd->SetToBeBroadcasted(false);        
+
+  fFastSimulationCmd = new G4UIcmdWithAString("/microyz/phys/fastSimulation",this);  
+  fFastSimulationCmd->SetGuidance("Particles handed to the fast simulation models, e.g. proton");
+  fFastSimulationCmd->SetGuidance("for the transport envelope (/microyz/fastsim/); none disables it.");
+  fFastSimulationCmd->SetParameterName("particles",false);
+  fFastSimulationCmd->AvailableForStates(G4State_PreInit);
+  fFastSimulationCmd->SetToBeBroadcasted(false);        
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 PhysicsListMessenger::~PhysicsListMessenger()
 {
+  delete fFastSimulationCmd;
+  delete fBiasingCmd;
+  delete fTableCacheCmd;
+  delete fDnaRegionCmd;
   delete fListCmd;
   delete fPhysDir;    
 }
@@ -69,6 +105,18 @@ void PhysicsListMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
 {       
   if( command == fListCmd )
    { fPhysicsList->AddPhysicsList(newValue);}
+
+  if( command == fDnaRegionCmd )
+   { fPhysicsList->SetDnaRegion(newValue);}
+
+  if( command == fTableCacheCmd )
+   { fPhysicsList->SetTableCache(newValue);}
+
+  if( command == fBiasingCmd )
+   { fPhysicsList->SetBiasedParticles(newValue);}
+
+  if( command == fFastSimulationCmd )
+   { fPhysicsList->SetFastSimulationParticles(newValue);}
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -28,11 +28,21 @@
 /// \brief Implementation of the B4::PrimaryGeneratorAction class
 
 #include "PrimaryGeneratorAction.hh"
+#include "PrimaryGeneratorMessenger.hh"
+#include "JobPartition.hh"
 #include "G4RunManager.hh"
 #include "G4LogicalVolumeStore.hh"
 #include "G4LogicalVolume.hh"
 #include "G4Tubs.hh"
 #include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4Threading.hh"
+#include "G4UnitsTable.hh"
 
 // For GPS
 #include "G4GeneralParticleSource.hh"
@@ -43,8 +53,11 @@
 #include "G4ParticleTable.hh"
 #include "G4ParticleDefinition.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
 #include "Randomize.hh"
 
+#include <cmath>
+
 namespace B4
 {
 
@@ -52,8 +65,10 @@ namespace B4
 
 // Constructor
 PrimaryGeneratorAction::PrimaryGeneratorAction()
+ : fBiasMargin(10 * um)
 {
   fParticleGun = new G4GeneralParticleSource();
+  fMessenger = new PrimaryGeneratorMessenger(this);
 
   // Set default particle as  proton
   auto particleDef = G4ParticleTable::GetParticleTable()->FindParticle("proton");
@@ -109,6 +124,7 @@ PrimaryGeneratorAction::PrimaryGeneratorAction()
 
 PrimaryGeneratorAction::~PrimaryGeneratorAction()
 {
+  delete fMessenger;
   delete fParticleGun;
 }
 
@@ -118,8 +134,145 @@ void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
   // This function is called at the beginning of event
 
+  // Seed the event from its global event ID in a partitioned run
+  JobPartition::SeedEvent(anEvent->GetEventID());
+
+  // Replay the phase space, stop the run once it is exhausted (the current
+  // event is then tracked without primaries and not scored by EventAction)
+  if ( fPhaseSpaceReader.IsEnabled() ) {
+    if ( ! fPhaseSpaceReader.GeneratePrimaries(anEvent) ) {
+      G4RunManager::GetRunManager()->AbortRun(true);
+    }
+    return;
+  }
+
   // Generate particle and assign it to the event
   fParticleGun->GeneratePrimaryVertex(anEvent);
+
+  // Move part of the primaries toward the nanoparticle grid
+  if ( fBiasFraction > 0. ) {
+    BiasVertex(anEvent->GetPrimaryVertex());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PrimaryGeneratorAction::FindBiasArea()
+{
+  // Importance area: projection of the root volume of the Nanodosimetry
+  // region (the nanoparticle grid) along the beam axis z
+  auto region = G4RegionStore::GetInstance()->GetRegion("Nanodosimetry", false);
+  if ( region == nullptr || region->GetNumberOfRootVolumes() == 0 ) return false;
+  auto rootLV = *(region->GetRootLogicalVolumeIterator());
+
+  auto findPlacement = [](const G4LogicalVolume* logicalVolume) {
+    for ( auto pv : *G4PhysicalVolumeStore::GetInstance() ) {
+      if ( pv->GetLogicalVolume() == logicalVolume ) return pv;
+    }
+    return static_cast<G4VPhysicalVolume*>(nullptr);
+  };
+
+  auto rootPV = findPlacement(rootLV);
+  if ( rootPV == nullptr ) return false;
+
+  // The root volume is placed without rotation, in the world or in the
+  // importance shells around it (DetectorConstruction)
+  G4ThreeVector translation = rootPV->GetTranslation();
+  for ( auto pv = findPlacement(rootPV->GetMotherLogical()); pv != nullptr;
+        pv = findPlacement(pv->GetMotherLogical()) ) {
+    translation += pv->GetTranslation();
+  }
+
+  G4ThreeVector pMin, pMax;
+  rootLV->GetSolid()->BoundingLimits(pMin, pMax);
+  fBiasCenter = translation + 0.5 * (pMin + pMax);
+  fBiasHalfSize = 0.5 * (pMax - pMin);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction::BiasVertex(G4PrimaryVertex* vertex)
+{
+  if ( vertex == nullptr ) return;
+
+  if ( ! fBiasAreaFound ) {
+    fBiasAreaFound = FindBiasArea();
+    if ( ! fBiasAreaFound ) {
+      G4Exception("PrimaryGeneratorAction::BiasVertex()",
+        "MyCode0014", JustWarning,
+        "No Nanodosimetry region, source biasing is switched off.");
+      fBiasFraction = 0.;
+      return;
+    }
+  }
+
+  // Analog source: a plane perpendicular to z, read every event as the
+  // /gps/ commands may change it between runs
+  auto posDist = fParticleGun->GetCurrentSource()->GetPosDist();
+  const auto& shape = posDist->GetPosDisShape();
+  const auto centre = posDist->GetCentreCoords();
+  G4bool isCircle = ( shape == "Circle" );
+  G4bool isPlane = ( posDist->GetPosDisType() == "Plane" )
+                   && ( isCircle || shape == "Square" || shape == "Rectangle" )
+                   && ( posDist->GetRotz().z() > 1. - 1.e-9 );
+
+  // Importance area, it has to lie inside the source
+  const G4double bx = fBiasHalfSize.x() + fBiasMargin;
+  const G4double by = fBiasHalfSize.y() + fBiasMargin;
+  const G4double dx = std::abs(fBiasCenter.x() - centre.x()) + bx;
+  const G4double dy = std::abs(fBiasCenter.y() - centre.y()) + by;
+  G4double sourceArea = 0.;
+  G4bool isInside = false;
+  if ( isCircle ) {
+    const G4double radius = posDist->GetRadius();
+    sourceArea = pi * radius * radius;
+    isInside = ( dx * dx + dy * dy <= radius * radius );
+  }
+  else {
+    const G4double halfX = posDist->GetHalfX();
+    const G4double halfY = ( shape == "Square" ) ? halfX : posDist->GetHalfY();
+    sourceArea = 4. * halfX * halfY;
+    isInside = ( dx <= halfX && dy <= halfY );
+  }
+
+  if ( ! isPlane || ! isInside ) {
+    G4ExceptionDescription msg;
+    msg << "Source biasing needs a GPS of type Plane (Circle, Square, Rectangle)"
+        << G4endl
+        << "perpendicular to z which covers the projection of the Nanodosimetry"
+        << G4endl
+        << "region with margin, source biasing is switched off.";
+    G4Exception("PrimaryGeneratorAction::BiasVertex()",
+      "MyCode0014", JustWarning, msg);
+    fBiasFraction = 0.;
+    return;
+  }
+
+  // Mixture of the analog source and the importance area
+  const G4double biasArea = 4. * bx * by;
+  const G4double weightInside
+    = 1. / (fBiasFraction * sourceArea / biasArea + 1. - fBiasFraction);
+  const G4double weightOutside = 1. / (1. - fBiasFraction);
+
+  if ( G4Threading::G4GetThreadId() <= 0 && fPrintBias ) {
+    G4cout << "Source biasing: " << 100. * fBiasFraction << " % of the primaries in "
+           << G4BestUnit(2. * bx, "Length") << " x " << G4BestUnit(2. * by, "Length")
+           << ", weights " << weightInside << " (inside), "
+           << weightOutside << " (outside)" << G4endl;
+    fPrintBias = false;
+  }
+
+  auto position = vertex->GetPosition();
+  if ( G4UniformRand() < fBiasFraction ) {
+    position.setX(fBiasCenter.x() + bx * (2. * G4UniformRand() - 1.));
+    position.setY(fBiasCenter.y() + by * (2. * G4UniformRand() - 1.));
+    vertex->SetPosition(position.x(), position.y(), position.z());
+  }
+
+  const G4bool inArea = std::abs(position.x() - fBiasCenter.x()) <= bx
+                        && std::abs(position.y() - fBiasCenter.y()) <= by;
+  vertex->SetWeight(vertex->GetWeight() * (inArea ? weightInside : weightOutside));
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,140 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PrimaryGeneratorMessenger.cc
+/// \brief Implementation of the B4::PrimaryGeneratorMessenger class
+
+#include "PrimaryGeneratorMessenger.hh"
+#include "PrimaryGeneratorAction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWith3VectorAndUnit.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+namespace B4
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PrimaryGeneratorMessenger::PrimaryGeneratorMessenger(PrimaryGeneratorAction* action)
+ : fAction(action)
+{
+  fSourceDir = new G4UIdirectory("/microyz/source/");
+  fSourceDir->SetGuidance("phase-space replay and biasing of the primary source");
+
+  fFileCmd = new G4UIcmdWithAString("/microyz/source/phaseSpaceFile", this);
+  fFileCmd->SetGuidance("Phase-space file written with /microyz/output/phaseSpaceFile");
+  fFileCmd->SetGuidance("to replay instead of the GPS (none = use the GPS).");
+  fFileCmd->SetParameterName("file", false);
+  fFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fPassesCmd = new G4UIcmdWithAnInteger("/microyz/source/phaseSpacePasses", this);
+  fPassesCmd->SetGuidance("Number of passes over the phase-space file (0 = unlimited),");
+  fPassesCmd->SetGuidance("the run is stopped when they are exhausted.");
+  fPassesCmd->SetParameterName("passes", false);
+  fPassesCmd->SetRange("passes >= 0");
+  fPassesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fShiftCmd = new G4UIcmdWith3VectorAndUnit("/microyz/source/phaseSpaceShift", this);
+  fShiftCmd->SetGuidance("Translation applied to the replayed particles.");
+  fShiftCmd->SetParameterName("dx", "dy", "dz", false);
+  fShiftCmd->SetUnitCategory("Length");
+  fShiftCmd->SetDefaultUnit("mm");
+  fShiftCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fRandomRotationCmd
+    = new G4UIcmdWithABool("/microyz/source/phaseSpaceRandomRotation", this);
+  fRandomRotationCmd->SetGuidance("Rotate the replayed particles of each event by a random");
+  fRandomRotationCmd->SetGuidance("angle about the z axis (axially symmetric beams only).");
+  fRandomRotationCmd->SetParameterName("rotate", true);
+  fRandomRotationCmd->SetDefaultValue(true);
+  fRandomRotationCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fBiasFractionCmd = new G4UIcmdWithADouble("/microyz/source/biasFraction", this);
+  fBiasFractionCmd->SetGuidance("Fraction of the GPS positions resampled in the projection");
+  fBiasFractionCmd->SetGuidance("of the nanoparticle grid, the events are weighted accordingly");
+  fBiasFractionCmd->SetGuidance("(0 = analog source).");
+  fBiasFractionCmd->SetParameterName("fraction", false);
+  fBiasFractionCmd->SetRange("fraction >= 0. && fraction < 1.");
+  fBiasFractionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fBiasMarginCmd = new G4UIcmdWithADoubleAndUnit("/microyz/source/biasMargin", this);
+  fBiasMarginCmd->SetGuidance("Lateral margin of the biased area around the projection");
+  fBiasMarginCmd->SetGuidance("of the nanoparticle grid.");
+  fBiasMarginCmd->SetParameterName("margin", false);
+  fBiasMarginCmd->SetRange("margin >= 0.");
+  fBiasMarginCmd->SetUnitCategory("Length");
+  fBiasMarginCmd->SetDefaultUnit("um");
+  fBiasMarginCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PrimaryGeneratorMessenger::~PrimaryGeneratorMessenger()
+{
+  delete fBiasMarginCmd;
+  delete fBiasFractionCmd;
+  delete fRandomRotationCmd;
+  delete fShiftCmd;
+  delete fPassesCmd;
+  delete fFileCmd;
+  delete fSourceDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fFileCmd ) {
+    fAction->GetPhaseSpaceReader().SetFileName(newValue == "none" ? G4String() : newValue);
+  }
+  else if ( command == fPassesCmd ) {
+    fAction->GetPhaseSpaceReader().SetNofPasses(
+      G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+  }
+  else if ( command == fShiftCmd ) {
+    fAction->GetPhaseSpaceReader().SetShift(
+      G4UIcmdWith3VectorAndUnit::GetNew3VectorValue(newValue));
+  }
+  else if ( command == fRandomRotationCmd ) {
+    fAction->GetPhaseSpaceReader().SetRandomRotation(
+      G4UIcmdWithABool::GetNewBoolValue(newValue));
+  }
+  else if ( command == fBiasFractionCmd ) {
+    fAction->SetBiasFraction(G4UIcmdWithADouble::GetNewDoubleValue(newValue));
+  }
+  else if ( command == fBiasMarginCmd ) {
+    fAction->SetBiasMargin(G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
@@ -0,0 +1,136 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ProgressReporter.cc
+/// \brief Implementation of the B4::ProgressReporter class
+
+#include "ProgressReporter.hh"
+#include "ConcurrentHistogram.hh"
+
+#include <cstdio>
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  Clock::rep Now()
+  {
+    return Clock::now().time_since_epoch().count();
+  }
+
+  G4double ToSeconds(Clock::rep ticks)
+  {
+    return std::chrono::duration<G4double>(Clock::duration(ticks)).count();
+  }
+
+  Clock::rep ToTicks(G4double seconds)
+  {
+    return std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<G4double>(seconds)).count();
+  }
+}
+
+namespace B4
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProgressReporter::BeginOfRun(G4int nofEvents)
+{
+  fEventsDone = 0;
+  fTotalEvents = nofEvents;
+  fNextReport = ToTicks(fInterval);
+  fStartTime = Now();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProgressReporter::EventDone()
+{
+  auto done = fEventsDone.fetch_add(1, std::memory_order_relaxed) + 1;
+  if ( fVerboseLevel < 1 || fInterval <= 0. ) return;
+
+  auto elapsed = Now() - fStartTime.load(std::memory_order_relaxed);
+  auto next = fNextReport.load(std::memory_order_relaxed);
+  if ( elapsed < next ) return;
+
+  // Only the thread which moves the next report time prints
+  if ( ! fNextReport.compare_exchange_strong(next, elapsed + ToTicks(fInterval)) ) {
+    return;
+  }
+  Report(done, ToSeconds(elapsed));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProgressReporter::EndOfRun() const
+{
+  if ( fVerboseLevel < 1 ) return;
+
+  auto done = fEventsDone.load();
+  auto elapsed = ToSeconds(Now() - fStartTime.load());
+  G4cout << G4endl
+         << " ----> " << done << " events in " << elapsed << " s";
+  if ( elapsed > 0. ) G4cout << " (" << done / elapsed << " events/s)";
+  G4cout << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProgressReporter::Report(G4long nofEventsDone, G4double elapsed) const
+{
+  auto total = fTotalEvents.load(std::memory_order_relaxed);
+  auto rate = elapsed > 0. ? nofEventsDone / elapsed : 0.;
+
+  char line[224];
+  auto size = std::snprintf(line, sizeof(line),
+                            "---> %ld of %ld events (%.1f %%), %.1f events/s",
+                            nofEventsDone, total,
+                            total > 0 ? 100. * nofEventsDone / total : 0., rate);
+  if ( fLiveClusterSizes != nullptr ) {
+    // Bins of width 1 from nu = 0, F2 = 1 - P(0) - P(1)
+    auto clusterSizes = fLiveClusterSizes->GetSnapshot();
+    if ( clusterSizes.sumW > 0. && clusterSizes.bins.size() > 2 ) {
+      auto m1 = clusterSizes.GetMean();
+      auto f2 = 1. - ( clusterSizes.bins[0] + clusterSizes.bins[1]
+                       + clusterSizes.bins[2] ) / clusterSizes.sumW;
+      size += std::snprintf(line + size, sizeof(line) - size,
+                            ", M1 %.4g (%.2g %%), F2 %.4g", m1,
+                            m1 > 0. ? 100. * clusterSizes.GetMeanError() / m1 : 0.,
+                            f2);
+    }
+  }
+  if ( rate > 0. && total > nofEventsDone ) {
+    auto eta = G4long((total - nofEventsDone) / rate);
+    std::snprintf(line + size, sizeof(line) - size, ", ETA %ld:%02ld:%02ld",
+                  eta / 3600, (eta / 60) % 60, eta % 60);
+  }
+  G4cout << line << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
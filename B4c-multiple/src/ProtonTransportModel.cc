@@ -0,0 +1,313 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ProtonTransportModel.cc
+/// \brief Implementation of the B4c::ProtonTransportModel class
+
+#include "ProtonTransportModel.hh"
+
+#include "G4Electron.hh"
+#include "G4EmCalculator.hh"
+#include "G4FastStep.hh"
+#include "G4FastTrack.hh"
+#include "G4IonisParamMat.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Proton.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "G4Track.hh"
+#include "G4UnitsTable.hh"
+#include "G4VSolid.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  // Energy grid of the range table
+  const G4double kEmin = 1 * CLHEP::MeV;
+  const G4double kEmax = 10 * CLHEP::GeV;
+  const G4int    kNofBinsPerDecade = 20;
+
+  // Shorter distances to the surface are left to the full simulation
+  const G4double kMinDistance = 1 * CLHEP::um;
+
+  // Energy grid of the delta electron range in CheckGap()
+  const G4double kElectronEmin = 1 * CLHEP::keV;
+  const G4int    kNofElectronBins = 100;
+}
+
+namespace B4c
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ProtonTransportModel::ProtonTransportModel(const G4String& name, G4Region* envelope)
+ : G4VFastSimulationModel(name, envelope),
+   fMinEnergy(10 * MeV),
+   fGap(std::numeric_limits<G4double>::infinity())
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ProtonTransportModel::IsApplicable(const G4ParticleDefinition& particle)
+{
+  return &particle == G4Proton::Definition();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ProtonTransportModel::ModelTrigger(const G4FastTrack& fastTrack)
+{
+  auto track = fastTrack.GetPrimaryTrack();
+  if ( track->GetParentID() != 0 ) return false;
+
+  G4double energy = track->GetKineticEnergy();
+  if ( energy < fMinEnergy || energy >= kEmax ) return false;
+
+  Initialise(fastTrack.GetEnvelopeLogicalVolume()->GetMaterial());
+  if ( energy > fCheckedEnergy ) CheckGap(energy);
+
+  G4double distance = fastTrack.GetEnvelopeSolid()->DistanceToOut(
+    fastTrack.GetPrimaryTrackLocalPosition(),
+    fastTrack.GetPrimaryTrackLocalDirection());
+  if ( distance < kMinDistance ) return false;
+
+  // Mean exit energy above the minimum energy
+  return GetRange(energy) - distance > GetRange(std::max(fMinEnergy, kEmin));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProtonTransportModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep)
+{
+  auto track = fastTrack.GetPrimaryTrack();
+  auto solid = fastTrack.GetEnvelopeSolid();
+  G4ThreeVector position = fastTrack.GetPrimaryTrackLocalPosition();
+  G4ThreeVector direction = fastTrack.GetPrimaryTrackLocalDirection();
+  G4double energy = track->GetKineticEnergy();
+  G4double mass = track->GetDefinition()->GetPDGMass();
+
+  // Kinematics at half of the straight path to the surface
+  G4double distance = solid->DistanceToOut(position, direction);
+  G4double meanEnergy = GetEnergy(GetRange(energy) - 0.5 * distance);
+  G4double momentum = std::sqrt(meanEnergy * (meanEnergy + 2. * mass));
+  G4double beta = momentum / (meanEnergy + mass);
+
+  // Multiple scattering: Highland width, deflection and lateral displacement
+  // sampled with their correlation in two orthogonal planes
+  G4double xOverX0 = distance / fMaterial->GetRadlen();
+  G4double theta0 = 13.6 * MeV / (beta * momentum) * std::sqrt(xOverX0)
+                  * std::max(1. + 0.038 * std::log(xOverX0 / (beta * beta)), 0.);
+
+  G4ThreeVector u = direction.orthogonal().unit();
+  G4ThreeVector v = direction.cross(u);
+  G4double displacement[2], deflection[2];
+  for ( G4int i = 0; i < 2; ++i ) {
+    G4double z1 = G4RandGauss::shoot();
+    G4double z2 = G4RandGauss::shoot();
+    displacement[i] = distance * theta0 * (z1 / std::sqrt(12.) + 0.5 * z2);
+    deflection[i] = theta0 * z2;
+  }
+
+  // The shifted straight path defines the exit point, unless the shift
+  // leaves the envelope
+  G4ThreeVector start = position + displacement[0] * u + displacement[1] * v;
+  if ( solid->Inside(start) != kOutside ) {
+    distance = solid->DistanceToOut(start, direction);
+  }
+  else {
+    start = position;
+  }
+  G4ThreeVector exitPosition = start + distance * direction;
+  G4ThreeVector exitDirection
+    = (direction + deflection[0] * u + deflection[1] * v).unit();
+
+  // Energy loss: mean from the range, Gaussian straggling
+  G4double meanLoss = energy - GetEnergy(GetRange(energy) - distance);
+  G4double tau = meanEnergy / mass;
+  G4double ratio = electron_mass_c2 / mass;
+  G4double tmax = 2. * electron_mass_c2 * tau * (tau + 2.)
+                / (1. + 2. * (tau + 1.) * ratio + ratio * ratio);
+  G4double variance = twopi_mc2_rcl2 * fMaterial->GetElectronDensity() * distance
+                    * tmax * (1. / (beta * beta) - 0.5);
+  G4double loss = G4RandGauss::shoot(meanLoss, std::sqrt(variance));
+  loss = std::min(std::max(loss, 0.), energy);
+
+  fastStep.ProposePrimaryTrackFinalPosition(exitPosition);
+  fastStep.ProposePrimaryTrackFinalMomentumDirection(exitDirection);
+  fastStep.ProposePrimaryTrackFinalTime(
+    track->GetGlobalTime() + distance / (beta * c_light));
+  fastStep.ProposePrimaryTrackPathLength(distance);
+  fastStep.ProposeTotalEnergyDeposited(loss);
+  if ( loss < energy ) {
+    fastStep.ProposePrimaryTrackFinalKineticEnergy(energy - loss);
+  }
+  else {
+    fastStep.KillPrimaryTrack();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProtonTransportModel::Initialise(const G4Material* material)
+{
+  if ( material == fMaterial ) return;
+  fMaterial = material;
+
+  // Proton CSDA range, trapezoidal integration of 1/(dE/dx). Below the
+  // lowest energy the stopping power of that energy is used, only range
+  // differences above the minimum energy enter the model.
+  const G4int nofBins
+    = G4int(std::lround(kNofBinsPerDecade * std::log10(kEmax / kEmin)));
+  fLogEmin = std::log(kEmin);
+  fInvLogStep = nofBins / std::log(kEmax / kEmin);
+  fRanges.resize(nofBins + 1);
+
+  G4double previousEnergy = kEmin;
+  G4double previousDEDX = ComputeDEDX(kEmin);
+  fRanges[0] = kEmin / previousDEDX;
+  for ( G4int i = 1; i <= nofBins; ++i ) {
+    G4double energy = std::exp(fLogEmin + i / fInvLogStep);
+    G4double dedx = ComputeDEDX(energy);
+    fRanges[i] = fRanges[i - 1]
+      + 0.5 * (1. / dedx + 1. / previousDEDX) * (energy - previousEnergy);
+    previousEnergy = energy;
+    previousDEDX = dedx;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProtonTransportModel::CheckGap(G4double energy)
+{
+  fCheckedEnergy = energy;
+
+  // Maximum energy transfer to a delta electron, that of the entrance energy
+  // bounds the one at the envelope exit
+  G4double mass = proton_mass_c2;
+  G4double tau = energy / mass;
+  G4double ratio = electron_mass_c2 / mass;
+  G4double tmax = 2. * electron_mass_c2 * tau * (tau + 2.)
+                / (1. + 2. * (tau + 1.) * ratio + ratio * ratio);
+  if ( tmax <= kElectronEmin ) return;
+
+  // Its CSDA range, trapezoidal integration of 1/(dE/dx) as in
+  // RoiTrackFilter; without continuous energy loss of electrons it is not
+  // checked
+  G4EmCalculator calculator;
+  auto electron = G4Electron::Definition();
+  G4double logStep = std::log(tmax / kElectronEmin) / kNofElectronBins;
+  G4double previousEnergy = kElectronEmin;
+  G4double previousDEDX
+    = calculator.ComputeTotalDEDX(kElectronEmin, electron, fMaterial);
+  if ( previousDEDX <= 0. ) return;
+  G4double range = kElectronEmin / previousDEDX;
+  for ( G4int i = 1; i <= kNofElectronBins; ++i ) {
+    G4double electronEnergy = kElectronEmin * std::exp(i * logStep);
+    G4double dedx = calculator.ComputeTotalDEDX(electronEnergy, electron, fMaterial);
+    if ( dedx <= 0. ) return;
+    range += 0.5 * (1. / dedx + 1. / previousDEDX) * (electronEnergy - previousEnergy);
+    previousEnergy = electronEnergy;
+    previousDEDX = dedx;
+  }
+
+  if ( range <= fGap || G4Threading::G4GetThreadId() > 0 ) return;
+
+  G4ExceptionDescription msg;
+  msg << "Delta electrons of " << G4BestUnit(energy, "Energy")
+      << " protons (up to " << G4BestUnit(tmax, "Energy")
+      << ", CSDA range " << G4BestUnit(range, "Length")
+      << ") are not produced in the transport envelope, the gap of "
+      << G4BestUnit(fGap, "Length") << " to the grid is too short for them."
+      << G4endl
+      << "The grid misses the delta electrons of the envelope, shorten"
+      << " /microyz/fastsim/envelopeLength by "
+      << G4BestUnit(range - fGap, "Length") << ".";
+  G4Exception("ProtonTransportModel::CheckGap()",
+    "MyCode0022", JustWarning, msg);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ProtonTransportModel::ComputeDEDX(G4double energy) const
+{
+  // Bethe formula without restriction of the energy transfer
+  G4double mass = proton_mass_c2;
+  G4double tau = energy / mass;
+  G4double gamma = tau + 1.;
+  G4double bg2 = tau * (tau + 2.);
+  G4double beta2 = bg2 / (gamma * gamma);
+  G4double ratio = electron_mass_c2 / mass;
+  G4double tmax = 2. * electron_mass_c2 * bg2
+                / (1. + 2. * gamma * ratio + ratio * ratio);
+
+  auto ionisation = fMaterial->GetIonisation();
+  G4double eexc = ionisation->GetMeanExcitationEnergy();
+  G4double x = std::log(bg2) / (2. * std::log(10.));
+
+  G4double dedx = std::log(2. * electron_mass_c2 * bg2 * tmax / (eexc * eexc))
+                - 2. * beta2 - ionisation->DensityCorrection(x);
+  dedx *= twopi_mc2_rcl2 * fMaterial->GetElectronDensity() / beta2;
+  return std::max(dedx, 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ProtonTransportModel::GetRange(G4double energy) const
+{
+  if ( energy <= kEmin ) {
+    return fRanges.front() * energy / kEmin;
+  }
+
+  G4double x = (std::log(energy) - fLogEmin) * fInvLogStep;
+  auto i = std::min(std::size_t(x), fRanges.size() - 2);
+  G4double f = x - i;
+  return (1. - f) * fRanges[i] + f * fRanges[i + 1];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ProtonTransportModel::GetEnergy(G4double range) const
+{
+  if ( range <= fRanges.front() ) {
+    return kEmin * std::max(range, 0.) / fRanges.front();
+  }
+
+  auto upper = std::upper_bound(fRanges.begin(), fRanges.end(), range);
+  if ( upper == fRanges.end() ) return kEmax;
+  std::size_t i = upper - fRanges.begin() - 1;
+  G4double f = (range - fRanges[i]) / (fRanges[i + 1] - fRanges[i]);
+  return std::exp(fLogEmin + (i + f) / fInvLogStep);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
@@ -29,21 +29,35 @@
 
 // Header file inclusions
 #include "RunAction.hh"
+#include "RunActionMessenger.hh"
+#include "RunData.hh"
+#include "SharedRunData.hh"
+#include "CalorimeterSD.hh"
+#include "JobPartition.hh"
+#include "PhysicsList.hh"
 #include "G4AnalysisManager.hh"
+#include "G4AccumulableManager.hh"
 #include "G4Run.hh"
 #include "G4RunManager.hh"
+#include "G4SDManager.hh"
 #include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "G4VProcess.hh"
 
 namespace B4
 {
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-RunAction::RunAction()
+RunAction::RunAction(RunData* runData)
+ : fRunData(runData)
 {
-  // Set printing event number per each event
-  G4RunManager::GetRunManager()->SetPrintProgress(1);
+  // The accumulables of this thread are registered by its RunData
+  fMessenger = new RunActionMessenger(fRunData);
+
+  // The progress is reported by the ProgressReporter in time intervals,
+  // per event printing is left to /run/printProgress
 
   // Create analysis manager
   // The choice of the output format is done via the specified
@@ -85,37 +99,206 @@ RunAction::RunAction()
   analysisManager->CreateNtuple("B4", "Edep and TrackL");
   analysisManager->CreateNtupleDColumn("ESphere");
   analysisManager->CreateNtupleDColumn("LSphere");
+  analysisManager->CreateNtupleDColumn("Weight");
   analysisManager->FinishNtuple();
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 }
 RunAction::~RunAction()
-{}
+{
+  delete fMessenger;
+  delete fRunData;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void RunAction::BeginOfRunAction(const G4Run* /*run*/)
+void RunAction::BeginOfRunAction(const G4Run* run)
 {
   //inform the runManager to save random number seed
   //G4RunManager::GetRunManager()->SetRandomNumberStore(true);
 
+  // Reset accumulables to their initial values
+  G4AccumulableManager::Instance()->Reset();
+
+  // Reset the live cluster sizes, the convergence sums and the progress
+  // shared by the threads, fix the global event IDs of the run
+  if ( isMaster ) {
+    JobPartition::BeginOfRun(run);
+    fRunData->GetShared().BeginOfRun(run->GetNumberOfEventToBeProcessed());
+  }
+
+  // Hand the run data of this thread to its sensitive detector
+  // (not built on the master of a multi-threaded run)
+  auto calorimeterSD = static_cast<B4c::CalorimeterSD*>(
+    G4SDManager::GetSDMpointer()->FindSensitiveDetector("SensitiveDetector", false));
+  if ( calorimeterSD != nullptr ) {
+    calorimeterSD->SetRunData(fRunData);
+  }
+
   // Get analysis manager
   auto analysisManager = G4AnalysisManager::Instance();
 
   // Open an output file
+  // (B4_job<i>of<N>.root in a job of a partitioned run)
   //
-  G4String fileName = "B4.root";
+  G4String fileName = JobPartition::FileName("B4.root");
   // Other supported output types:
   // G4String fileName = "B4.csv";
   // G4String fileName = "B4.hdf5";
   // G4String fileName = "B4.xml";
   analysisManager->OpenFile(fileName);
   G4cout << "Using " << analysisManager->GetType() << G4endl;
+
+  // Resolve the ionisation processes of this thread once per run,
+  // CalorimeterSD then classifies secondaries by pointer comparison
+  auto& ionisationClassifier = fRunData->GetIonisationClassifier();
+  ionisationClassifier.Resolve();
+  if ( isMaster ) {
+    G4cout << "Ionisation processes (" << ionisationClassifier.GetPatterns()
+           << "):";
+    for ( auto process : ionisationClassifier.GetProcesses() ) {
+      G4cout << " " << process->GetProcessName();
+    }
+    G4cout << G4endl;
+  }
+
+  // Print the models of the Geant4-DNA region once, the physics tables
+  // (and with them the models of the regions) are built by now
+  if ( isMaster && run->GetRunID() == 0 ) {
+    auto physicsList = dynamic_cast<const PhysicsList*>(
+      G4RunManager::GetRunManager()->GetUserPhysicsList());
+    if ( physicsList != nullptr ) physicsList->CheckDnaRegion();
+  }
+
+  // Locate the region of interest and tabulate the electron range of this
+  // thread, used by StackingAction and SteppingAction to kill tracks
+  auto& roiTrackFilter = fRunData->GetRoiTrackFilter();
+  roiTrackFilter.Initialise();
+  if ( isMaster && roiTrackFilter.IsEnabled() ) {
+    G4cout << "Killing tracks that can not reach the region of interest: centre "
+           << G4BestUnit(roiTrackFilter.GetRoiCenter(), "Length")
+           << ", half size "
+           << G4BestUnit(roiTrackFilter.GetRoiHalfSize(), "Length")
+           << ", range safety " << roiTrackFilter.GetRangeSafety() << G4endl;
+  }
+
+  // Open the per-event output shards of this thread, if enabled
+  // (the master only merges, unless the run is sequential)
+  if ( fRunData->GetWriteEventRecords()
+       && ( ! isMaster || ! G4Threading::IsMultithreadedApplication() ) ) {
+    fRunData->GetEventOutput().Open(JobPartition::FileName("data.txt"));
+    fRunData->GetCellOutput().Open(JobPartition::FileName("cells.txt"));
+  }
+
+  // Open the phase-space shard of this thread, if enabled
+  auto& phaseSpaceWriter = fRunData->GetPhaseSpaceWriter();
+  if ( phaseSpaceWriter.IsEnabled()
+       && ( ! isMaster || ! G4Threading::IsMultithreadedApplication() ) ) {
+    phaseSpaceWriter.Open();
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void RunAction::EndOfRunAction(const G4Run* /*run*/)
+void RunAction::EndOfRunAction(const G4Run* run)
 {
+  // Merge accumulables
+  G4AccumulableManager::Instance()->Merge();
+
+  // Print the convergence of the events of all threads
+  auto& sharedRunData = fRunData->GetShared();
+  if ( isMaster && sharedRunData.GetConvergenceMonitor().IsEnabled() ) {
+    sharedRunData.GetConvergenceMonitor().Report();
+  }
+
+  // Print the throughput of the entire run
+  if ( isMaster ) {
+    sharedRunData.GetProgressReporter().EndOfRun();
+  }
+
+  // Print the steps removed by each stage of CalorimeterSD::ProcessHits()
+  if ( isMaster && fRunData->GetNofStepsProcessed() > 0 ) {
+    auto processed = fRunData->GetNofStepsProcessed();
+    auto percent = [processed](G4long n) { return 100. * n / processed; };
+    G4cout
+      << G4endl
+      << " ----> CalorimeterSD step filter for the entire run" << G4endl
+      << "  steps processed            : " << processed << G4endl
+      << "  rejected (no edep, length) : " << fRunData->GetNofStepsNoDeposit()
+      << " (" << percent(fRunData->GetNofStepsNoDeposit()) << " %)" << G4endl
+      << "  secondaries classified     : " << fRunData->GetNofStepsClassified()
+      << " (" << percent(fRunData->GetNofStepsClassified()) << " %)" << G4endl
+      << "  hits recorded              : " << fRunData->GetNofStepsRecorded()
+      << " (" << percent(fRunData->GetNofStepsRecorded()) << " %)" << G4endl;
+  }
+
+  // Print the tracks killed outside the region of interest
+  if ( isMaster && fRunData->GetRoiTrackFilter().IsEnabled() ) {
+    G4cout
+      << G4endl
+      << " ----> tracks killed outside the region of interest for the entire run"
+      << G4endl
+      << "  before stacking : " << fRunData->GetNofTracksKilledStacked() << G4endl
+      << "  in flight       : " << fRunData->GetNofTracksKilledInFlight() << G4endl
+      << "  steps tracked   : " << fRunData->GetNofStepsTracked() << G4endl;
+
+    // Steps saved, estimated from the CSDA range the killed electrons had
+    // left and the mean step length of the tracked steps (killed heavy
+    // charged particles are not included)
+    if ( fRunData->GetNofStepsTracked() > 0 ) {
+      auto meanStep
+        = fRunData->GetTrackLengthTracked() / fRunData->GetNofStepsTracked();
+      G4cout
+        << "  steps saved     : ~"
+        << G4long(fRunData->GetResidualRangeKilled() / meanStep)
+        << " (residual electron range "
+        << G4BestUnit(fRunData->GetResidualRangeKilled(), "Length")
+        << " / mean step " << G4BestUnit(meanStep, "Length") << ")" << G4endl;
+    }
+  }
+
+  // Write the cluster-size distribution of the entire run
+  const auto& clusterSizes = fRunData->GetClusterSizes();
+  if ( isMaster && clusterSizes.GetNofEvents() > 0 ) {
+    clusterSizes.Write(JobPartition::FileName("cluster_size.txt"),
+                       JobPartition::Header());
+    G4cout
+      << G4endl
+      << " ----> ionisation cluster size for the entire run ("
+      << clusterSizes.GetNofEvents() << " events)" << G4endl
+      << "  M1 = " << clusterSizes.GetM1() << " +- " << clusterSizes.GetM1Error()
+      << "  M2 = " << clusterSizes.GetM2()
+      << "  F1 = " << clusterSizes.GetCumulative(1)
+      << "  F2 = " << clusterSizes.GetCumulative(2) << G4endl;
+
+    // Efficiency of the biasing: events which scored compared to the analog
+    // probability, and the variance of M1 compared to an analog run of the
+    // same number of events
+    if ( clusterSizes.IsWeighted() ) {
+      auto nofEvents = clusterSizes.GetNofEvents();
+      G4cout
+        << "  weighted events: effective number = "
+        << clusterSizes.GetNofEffectiveEvents() << " of " << nofEvents << G4endl
+        << "  events with ionisations = "
+        << 100. * (nofEvents - clusterSizes.GetCount(0)) / nofEvents
+        << " % (analog " << 100. * clusterSizes.GetCumulative(1) << " %)" << G4endl
+        << "  efficiency gain in M1 per event = " << clusterSizes.GetM1Gain()
+        << G4endl;
+    }
+    if ( ! clusterSizes.IsExact() ) {
+      G4cout
+        << "  APPROXIMATE: " << clusterSizes.GetNofEstimatedEvents()
+        << " events with track weights differing from the event weight" << G4endl
+        << "  have estimated cluster sizes, M1 is unbiased but P(nu), M2, F1 and F2"
+        << " are not the nanodosimetric distribution" << G4endl;
+    }
+  }
+
+  // Save the exact sums of a job for mergeJobs, also without events
+  if ( isMaster && JobPartition::GetCount() > 1 ) {
+    clusterSizes.WriteSums(JobPartition::FileName("cluster_size_sums.txt"),
+                           JobPartition::Header());
+  }
+
   // Print histogram statistics
   //
   auto analysisManager = G4AnalysisManager::Instance();
@@ -143,6 +326,30 @@ void RunAction::EndOfRunAction(const G4Run* /*run*/)
   //
   analysisManager->Write();
   analysisManager->CloseFile();
+
+  // Flush the per-event and per-nanoparticle output of this thread, the
+  // master merges the shards of all threads into data.txt and cells.txt
+  fRunData->GetEventOutput().Close();
+  fRunData->GetCellOutput().Close();
+  if ( isMaster && fRunData->GetWriteEventRecords() ) {
+    OutputShard::MergeTextShards(JobPartition::FileName("data.txt"),
+      JobPartition::Header() + "EventID\tEnergy_eV\tIonYield\tWeight\n");
+    OutputShard::MergeTextShards(JobPartition::FileName("cells.txt"),
+      JobPartition::Header() + "EventID\tCellID\tEnergy_eV\tIonYield\tWeight\n");
+  }
+
+  // Close the phase-space shard of this thread, the master merges the
+  // shards of all threads into the phase-space file
+  auto& phaseSpaceWriter = fRunData->GetPhaseSpaceWriter();
+  phaseSpaceWriter.Close();
+  if ( isMaster && phaseSpaceWriter.IsEnabled() ) {
+    phaseSpaceWriter.Merge(run->GetNumberOfEvent());
+  }
+
+  // The global event IDs of the next run follow those of this run
+  if ( isMaster ) {
+    JobPartition::EndOfRun();
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
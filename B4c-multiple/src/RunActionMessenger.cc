@@ -0,0 +1,351 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file RunActionMessenger.cc
+/// \brief Implementation of the B4::RunActionMessenger class
+
+#include "RunActionMessenger.hh"
+#include "RunData.hh"
+#include "SharedRunData.hh"
+#include "JobPartition.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <sstream>
+
+namespace B4
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RunActionMessenger::RunActionMessenger(RunData* runData)
+ : fRunData(runData)
+{
+  fOutputDir = new G4UIdirectory("/microyz/output/");
+  fOutputDir->SetGuidance("output file commands");
+
+  fEventRecordsCmd = new G4UIcmdWithABool("/microyz/output/eventRecords", this);
+  fEventRecordsCmd->SetGuidance("Write the per-event text records (data.txt, cells.txt).");
+  fEventRecordsCmd->SetGuidance("The cluster-size distribution (cluster_size.txt) is always written.");
+  fEventRecordsCmd->SetParameterName("write", true);
+  fEventRecordsCmd->SetDefaultValue(true);
+  fEventRecordsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fFullPrecisionCmd = new G4UIcmdWithABool("/microyz/output/fullPrecision", this);
+  fFullPrecisionCmd->SetGuidance("Write the energies and weights of the per-event records with");
+  fFullPrecisionCmd->SetGuidance("17 significant digits, for bit-wise comparisons of runs.");
+  fFullPrecisionCmd->SetParameterName("full", true);
+  fFullPrecisionCmd->SetDefaultValue(true);
+  fFullPrecisionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fPhaseSpaceFileCmd = new G4UIcmdWithAString("/microyz/output/phaseSpaceFile", this);
+  fPhaseSpaceFileCmd->SetGuidance("Write the particles crossing the capture plane to the given");
+  fPhaseSpaceFileCmd->SetGuidance("phase-space file and stop them (none = no capture).");
+  fPhaseSpaceFileCmd->SetGuidance("The file is replayed with /microyz/source/phaseSpaceFile.");
+  fPhaseSpaceFileCmd->SetParameterName("file", false);
+  fPhaseSpaceFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fPhaseSpacePlaneCmd
+    = new G4UIcmdWithADoubleAndUnit("/microyz/output/phaseSpacePlane", this);
+  fPhaseSpacePlaneCmd->SetGuidance("z position of the capture plane, particles are recorded");
+  fPhaseSpacePlaneCmd->SetGuidance("when they cross it in +z direction.");
+  fPhaseSpacePlaneCmd->SetParameterName("z", false);
+  fPhaseSpacePlaneCmd->SetUnitCategory("Length");
+  fPhaseSpacePlaneCmd->SetDefaultUnit("mm");
+  fPhaseSpacePlaneCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fScoringDir = new G4UIdirectory("/microyz/scoring/");
+  fScoringDir->SetGuidance("scoring commands");
+
+  fIonisationProcessesCmd
+    = new G4UIcmdWithAString("/microyz/scoring/ionisationProcesses", this);
+  fIonisationProcessesCmd->SetGuidance("Processes whose secondary electrons are counted as ionisations.");
+  fIonisationProcessesCmd->SetGuidance("Space separated list of process names, '*' matches any sequence,");
+  fIonisationProcessesCmd->SetGuidance("e.g. \"e-_G4DNAIonisation proton_G4DNAIonisation\". Default: *Ioni*");
+  fIonisationProcessesCmd->SetParameterName("processes", false);
+  fIonisationProcessesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fHitsCollectionCmd = new G4UIcmdWithABool("/microyz/scoring/hitsCollection", this);
+  fHitsCollectionCmd->SetGuidance("Make a hits collection of each event from the hit store of the");
+  fHitsCollectionCmd->SetGuidance("sensitive detector. The outputs do not need it, it costs one");
+  fHitsCollectionCmd->SetGuidance("allocation per hit and event. Default: false");
+  fHitsCollectionCmd->SetParameterName("make", true);
+  fHitsCollectionCmd->SetDefaultValue(true);
+  fHitsCollectionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fAllCellsHitsCollectionCmd
+    = new G4UIcmdWithABool("/microyz/scoring/allCellsHitsCollection", this);
+  fAllCellsHitsCollectionCmd->SetGuidance("Make a hits collection of each event with one new hit per cell");
+  fAllCellsHitsCollectionCmd->SetGuidance("and the total hit (number of cells + 1 hits), as allocated by the");
+  fAllCellsHitsCollectionCmd->SetGuidance("former per-event design. Baseline of the hit store benchmark");
+  fAllCellsHitsCollectionCmd->SetGuidance("(hitstore.mac). Default: false");
+  fAllCellsHitsCollectionCmd->SetParameterName("make", true);
+  fAllCellsHitsCollectionCmd->SetDefaultValue(true);
+  fAllCellsHitsCollectionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fConvergenceDir = new G4UIdirectory("/microyz/convergence/");
+  fConvergenceDir->SetGuidance("early stop of the run at a target precision");
+
+  fPrecisionCmd = new G4UIcmdWithADouble("/microyz/convergence/precision", this);
+  fPrecisionCmd->SetGuidance("Target relative standard error of the selected observables,");
+  fPrecisionCmd->SetGuidance("the run is stopped once all of them are below it (0 = off).");
+  fPrecisionCmd->SetParameterName("precision", false);
+  fPrecisionCmd->SetRange("precision >= 0.");
+  fPrecisionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fPrecisionCmd->SetToBeBroadcasted(false);
+
+  fObservablesCmd = new G4UIcmdWithAString("/microyz/convergence/observables", this);
+  fObservablesCmd->SetGuidance("Observables which have to reach the target precision.");
+  fObservablesCmd->SetGuidance("Space separated list of: edep ionYield hitFraction F2");
+  fObservablesCmd->SetGuidance("An unknown name leaves the selection unchanged.");
+  fObservablesCmd->SetParameterName("observables", false);
+  fObservablesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fObservablesCmd->SetToBeBroadcasted(false);
+
+  fMinEventsCmd = new G4UIcmdWithAnInteger("/microyz/convergence/minEvents", this);
+  fMinEventsCmd->SetGuidance("Minimum number of events before the run can be stopped.");
+  fMinEventsCmd->SetParameterName("events", false);
+  fMinEventsCmd->SetRange("events >= 0");
+  fMinEventsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fMinEventsCmd->SetToBeBroadcasted(false);
+
+  fReportIntervalCmd = new G4UIcmdWithAnInteger("/microyz/convergence/reportInterval", this);
+  fReportIntervalCmd->SetGuidance("Print the current uncertainties every given number of events (0 = never).");
+  fReportIntervalCmd->SetParameterName("events", false);
+  fReportIntervalCmd->SetRange("events >= 0");
+  fReportIntervalCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fReportIntervalCmd->SetToBeBroadcasted(false);
+
+  fProgressDir = new G4UIdirectory("/microyz/progress/");
+  fProgressDir->SetGuidance("progress report of the run");
+
+  fProgressIntervalCmd = new G4UIcmdWithADoubleAndUnit("/microyz/progress/interval", this);
+  fProgressIntervalCmd->SetGuidance("Time between two progress reports (0 = never).");
+  fProgressIntervalCmd->SetParameterName("interval", false);
+  fProgressIntervalCmd->SetRange("interval >= 0.");
+  fProgressIntervalCmd->SetUnitCategory("Time");
+  fProgressIntervalCmd->SetDefaultUnit("s");
+  fProgressIntervalCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fProgressIntervalCmd->SetToBeBroadcasted(false);
+
+  fProgressVerboseCmd = new G4UIcmdWithAnInteger("/microyz/progress/verbose", this);
+  fProgressVerboseCmd->SetGuidance("Verbose level of the progress report:");
+  fProgressVerboseCmd->SetGuidance("  0 : none");
+  fProgressVerboseCmd->SetGuidance("  1 : events, event rate and ETA every interval (default)");
+  fProgressVerboseCmd->SetGuidance("  2 : in addition the summary of every event");
+  fProgressVerboseCmd->SetParameterName("level", false);
+  fProgressVerboseCmd->SetRange("level >= 0 && level <= 2");
+  fProgressVerboseCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fProgressVerboseCmd->SetToBeBroadcasted(false);
+
+  fRoiDir = new G4UIdirectory("/microyz/roi/");
+  fRoiDir->SetGuidance("killing of tracks that can not reach the sensitive detectors");
+
+  fKillTracksCmd = new G4UIcmdWithABool("/microyz/roi/killTracks", this);
+  fKillTracksCmd->SetGuidance("Kill tracks that can not reach the Nanodosimetry region:");
+  fKillTracksCmd->SetGuidance("electrons out of range, heavy charged particles moving away.");
+  fKillTracksCmd->SetParameterName("kill", true);
+  fKillTracksCmd->SetDefaultValue(true);
+  fKillTracksCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fRangeSafetyCmd = new G4UIcmdWithADouble("/microyz/roi/rangeSafety", this);
+  fRangeSafetyCmd->SetGuidance("Factor applied to the CSDA ranges before they are compared");
+  fRangeSafetyCmd->SetGuidance("with the distance to the region (default 1.2).");
+  fRangeSafetyCmd->SetParameterName("factor", false);
+  fRangeSafetyCmd->SetRange("factor >= 1.");
+  fRangeSafetyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fJobDir = new G4UIdirectory("/microyz/job/");
+  fJobDir->SetGuidance("jobs of a partitioned run (exampleB4c --job i/N)");
+
+  fJobBeamOnCmd = new G4UIcmdWithAnInteger("/microyz/job/beamOn", this);
+  fJobBeamOnCmd->SetGuidance("Start a run with the share of this job of the given total");
+  fJobBeamOnCmd->SetGuidance("number of events (all of them without --job).");
+  fJobBeamOnCmd->SetParameterName("events", false);
+  fJobBeamOnCmd->SetRange("events >= 0");
+  fJobBeamOnCmd->AvailableForStates(G4State_Idle);
+  fJobBeamOnCmd->SetToBeBroadcasted(false);
+
+  fRandomDir = new G4UIdirectory("/microyz/random/");
+  fRandomDir->SetGuidance("per-event seeding of the random numbers");
+
+  fSeedCmd = new G4UIcmdWithAnInteger("/microyz/random/seed", this);
+  fSeedCmd->SetGuidance("Master seed of the per-event random numbers, every event is seeded");
+  fSeedCmd->SetGuidance("from it and its global event ID. It must be the same in all jobs");
+  fSeedCmd->SetGuidance("of a partitioned run (default 1).");
+  fSeedCmd->SetParameterName("seed", false);
+  fSeedCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSeedCmd->SetToBeBroadcasted(false);
+
+  fPerEventSeedsCmd = new G4UIcmdWithABool("/microyz/random/perEventSeeds", this);
+  fPerEventSeedsCmd->SetGuidance("Seed every event from the master seed and its global event ID,");
+  fPerEventSeedsCmd->SetGuidance("the results do not depend on the number of threads (default).");
+  fPerEventSeedsCmd->SetGuidance("false leaves the seeding to the run manager (/random/ commands),");
+  fPerEventSeedsCmd->SetGuidance("it is always on in a partitioned run.");
+  fPerEventSeedsCmd->SetParameterName("perEvent", true);
+  fPerEventSeedsCmd->SetDefaultValue(true);
+  fPerEventSeedsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fPerEventSeedsCmd->SetToBeBroadcasted(false);
+
+  fReplayCmd = new G4UIcmdWithAString("/microyz/random/replay", this);
+  fReplayCmd->SetGuidance("Re-simulate the events of the given global event IDs (space separated)");
+  fReplayCmd->SetGuidance("with the tracking verbose level of /microyz/random/replayVerbose.");
+  fReplayCmd->SetGuidance("The outputs are written with the suffix _replay (data_replay.txt).");
+  fReplayCmd->SetParameterName("eventIDs", false);
+  fReplayCmd->AvailableForStates(G4State_Idle);
+  fReplayCmd->SetToBeBroadcasted(false);
+
+  fReplayVerboseCmd = new G4UIcmdWithAnInteger("/microyz/random/replayVerbose", this);
+  fReplayVerboseCmd->SetGuidance("Tracking verbose level of the replayed events (default 1).");
+  fReplayVerboseCmd->SetParameterName("level", false);
+  fReplayVerboseCmd->SetRange("level >= 0");
+  fReplayVerboseCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fReplayVerboseCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RunActionMessenger::~RunActionMessenger()
+{
+  delete fReplayVerboseCmd;
+  delete fReplayCmd;
+  delete fPerEventSeedsCmd;
+  delete fSeedCmd;
+  delete fRandomDir;
+  delete fJobBeamOnCmd;
+  delete fJobDir;
+  delete fRangeSafetyCmd;
+  delete fKillTracksCmd;
+  delete fRoiDir;
+  delete fProgressVerboseCmd;
+  delete fProgressIntervalCmd;
+  delete fProgressDir;
+  delete fReportIntervalCmd;
+  delete fMinEventsCmd;
+  delete fObservablesCmd;
+  delete fPrecisionCmd;
+  delete fConvergenceDir;
+  delete fHitsCollectionCmd;
+  delete fAllCellsHitsCollectionCmd;
+  delete fIonisationProcessesCmd;
+  delete fScoringDir;
+  delete fPhaseSpacePlaneCmd;
+  delete fPhaseSpaceFileCmd;
+  delete fFullPrecisionCmd;
+  delete fEventRecordsCmd;
+  delete fOutputDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunActionMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fEventRecordsCmd ) {
+    fRunData->SetWriteEventRecords(G4UIcmdWithABool::GetNewBoolValue(newValue));
+  }
+  else if ( command == fFullPrecisionCmd ) {
+    fRunData->SetFullPrecision(G4UIcmdWithABool::GetNewBoolValue(newValue));
+  }
+  else if ( command == fPhaseSpaceFileCmd ) {
+    fRunData->GetPhaseSpaceWriter().SetFileName(
+      newValue == "none" ? G4String() : newValue);
+  }
+  else if ( command == fPhaseSpacePlaneCmd ) {
+    fRunData->GetPhaseSpaceWriter().SetPlane(
+      G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+  }
+  else if ( command == fIonisationProcessesCmd ) {
+    fRunData->GetIonisationClassifier().SetPatterns(newValue);
+  }
+  else if ( command == fHitsCollectionCmd ) {
+    fRunData->SetMakeHitsCollection(G4UIcmdWithABool::GetNewBoolValue(newValue));
+  }
+  else if ( command == fAllCellsHitsCollectionCmd ) {
+    fRunData->SetAllCellsHitsCollection(G4UIcmdWithABool::GetNewBoolValue(newValue));
+  }
+  else if ( command == fPrecisionCmd ) {
+    fRunData->GetShared().GetConvergenceMonitor().SetTargetPrecision(
+      G4UIcmdWithADouble::GetNewDoubleValue(newValue));
+  }
+  else if ( command == fObservablesCmd ) {
+    fRunData->GetShared().GetConvergenceMonitor().SetObservables(newValue);
+  }
+  else if ( command == fMinEventsCmd ) {
+    fRunData->GetShared().GetConvergenceMonitor().SetMinEvents(
+      G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+  }
+  else if ( command == fReportIntervalCmd ) {
+    fRunData->GetShared().GetConvergenceMonitor().SetReportInterval(
+      G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+  }
+  else if ( command == fProgressIntervalCmd ) {
+    fRunData->GetShared().GetProgressReporter().SetInterval(
+      G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue) / CLHEP::s);
+  }
+  else if ( command == fProgressVerboseCmd ) {
+    fRunData->GetShared().GetProgressReporter().SetVerboseLevel(
+      G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+  }
+  else if ( command == fKillTracksCmd ) {
+    fRunData->GetRoiTrackFilter().SetEnabled(
+      G4UIcmdWithABool::GetNewBoolValue(newValue));
+  }
+  else if ( command == fRangeSafetyCmd ) {
+    fRunData->GetRoiTrackFilter().SetRangeSafety(
+      G4UIcmdWithADouble::GetNewDoubleValue(newValue));
+  }
+  else if ( command == fJobBeamOnCmd ) {
+    JobPartition::BeamOn(G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+  }
+  else if ( command == fSeedCmd ) {
+    JobPartition::SetSeed(G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+  }
+  else if ( command == fPerEventSeedsCmd ) {
+    JobPartition::SetPerEventSeeding(G4UIcmdWithABool::GetNewBoolValue(newValue));
+  }
+  else if ( command == fReplayCmd ) {
+    std::vector<G4long> eventIDs;
+    std::istringstream in(newValue);
+    G4long eventID = 0;
+    while ( in >> eventID ) {
+      if ( eventID >= 0 ) eventIDs.push_back(eventID);
+    }
+    JobPartition::Replay(eventIDs, fReplayVerboseLevel);
+  }
+  else if ( command == fReplayVerboseCmd ) {
+    fReplayVerboseLevel = G4UIcmdWithAnInteger::GetNewIntValue(newValue);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
@@ -0,0 +1,126 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SplitOrRouletteOperation.cc
+/// \brief Implementation of the B4c::SplitOrRouletteOperation class
+
+#include "SplitOrRouletteOperation.hh"
+#include "ImportanceBiasingOperator.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "Randomize.hh"
+
+#include <cmath>
+
+namespace B4c
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SplitOrRouletteOperation::SplitOrRouletteOperation(
+  const G4String& name, const ImportanceBiasingOperator* biasingOperator)
+ : G4VBiasingOperation(name),
+   fOperator(biasingOperator)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double SplitOrRouletteOperation::DistanceToApplyOperation(
+  const G4Track*, G4double, G4ForceCondition* condition)
+{
+  // Called at every step, it does not limit the step
+  *condition = Forced;
+  return DBL_MAX;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VParticleChange* SplitOrRouletteOperation::GenerateBiasingFinalState(
+  const G4Track* track, const G4Step* step)
+{
+  fParticleChange.Initialize(*track);
+
+  // Only boundary crossings count. The first step of a copy is skipped, it
+  // can be a tiny step seen on the wrong side of the boundary it was created on.
+  auto postStepPoint = step->GetPostStepPoint();
+  if ( postStepPoint->GetStepStatus() != fGeomBoundary
+       || track->GetCurrentStepNumber() == 1 ) {
+    return &fParticleChange;
+  }
+
+  // The transportation has already moved the post-step point into the next volume
+  auto prePhysical = step->GetPreStepPoint()->GetPhysicalVolume();
+  auto postPhysical = postStepPoint->GetPhysicalVolume();
+  if ( prePhysical == nullptr || postPhysical == nullptr ) {
+    return &fParticleChange;
+  }
+
+  G4double preImportance = fOperator->GetImportance(prePhysical->GetLogicalVolume());
+  G4double postImportance = fOperator->GetImportance(postPhysical->GetLogicalVolume());
+  if ( preImportance <= 0. || postImportance <= 0.
+       || postImportance == preImportance ) {
+    return &fParticleChange;
+  }
+
+  G4double ratio = postImportance/preImportance;
+  G4double weight = track->GetWeight()/ratio;
+
+  if ( ratio > 1. ) {
+    // Splitting, the track itself is one of the copies
+    auto nofCopies = static_cast<G4int>(ratio);
+    if ( G4UniformRand() < ratio - nofCopies ) ++nofCopies;
+
+    // The copies carry the same weight as the track, which is also the
+    // parent weight the particle change gives its secondaries
+    fParticleChange.ProposeWeight(weight);
+    if ( nofCopies > 1 ) {
+      fParticleChange.SetNumberOfSecondaries(nofCopies - 1);
+      for ( G4int i = 1; i < nofCopies; ++i ) {
+        auto copy = new G4Track(*track);
+        copy->SetWeight(weight);
+        fParticleChange.AddSecondary(copy);
+      }
+    }
+  }
+  else {
+    // Russian roulette
+    if ( G4UniformRand() < ratio ) {
+      fParticleChange.ProposeWeight(weight);
+    }
+    else {
+      fParticleChange.ProposeTrackStatus(fStopAndKill);
+    }
+  }
+
+  return &fParticleChange;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
@@ -0,0 +1,259 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file mergeJobs.cc
+/// \brief Merges the outputs of the jobs of a partitioned run
+
+// Usage: mergeJobs nJobs [inputDirectory]
+//
+// Combines the outputs of the N jobs of a run partitioned with
+// exampleB4c --job i/N (copied into inputDirectory) into the outputs of a
+// single run in the current directory:
+// - cluster_size.txt from the exact sums cluster_size_sums_job<i>of<N>.txt,
+// - the event tables (data.txt, cells.txt, braggcurve_data.txt) merged in
+//   global event ID order,
+// - the histograms of B4.root (the ntuple is not merged).
+// The "# job" headers are checked first: all jobs of the same run and seed,
+// with contiguous event ranges. The result is the one of a single run with
+// --job 0/1, up to the summation order of weighted sums.
+
+#include "ClusterSizeAccumulator.hh"
+#include "JobPartition.hh"
+#include "OutputShard.hh"
+
+#include "G4RootAnalysisManager.hh"
+#include "G4RootAnalysisReader.hh"
+#include "G4UIcommand.hh"
+
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  void PrintUsage() {
+    G4cerr << " Usage: " << G4endl;
+    G4cerr << " mergeJobs nJobs [inputDirectory]" << G4endl;
+    G4cerr << "   merges the outputs of the jobs 0 to nJobs-1 found in the input"
+           << " directory (default: current)" << G4endl;
+    G4cerr << "   into the outputs of a single run in the current directory."
+           << G4endl;
+  }
+
+  // Header lines of an output file, up to its first record
+  G4String ReadHeader(const G4String& fileName)
+  {
+    std::ifstream file(fileName);
+    G4String header;
+    std::string line;
+    while ( std::getline(file, line) ) {
+      if ( ! line.empty() && std::isdigit(static_cast<unsigned char>(line[0])) ) break;
+      header += line + "\n";
+    }
+    return header;
+  }
+
+  // Header without the "# job" line of a job output
+  G4String StripJobHeader(const G4String& header)
+  {
+    G4String stripped;
+    std::istringstream in(header);
+    std::string line;
+    B4::JobPartition::JobInfo info;
+    while ( std::getline(in, line) ) {
+      if ( ! B4::JobPartition::ParseHeader(line, info) ) stripped += line + "\n";
+    }
+    return stripped;
+  }
+
+  // Existing files of all jobs, empty if there are none, false if some
+  // jobs are missing
+  G4bool FindJobFiles(const G4String& directory, const G4String& baseFileName,
+                      G4int nofJobs, std::vector<G4String>& fileNames)
+  {
+    fileNames.clear();
+    std::vector<G4String> missing;
+    for ( G4int i = 0; i < nofJobs; ++i ) {
+      auto fileName
+        = directory + "/" + B4::JobPartition::FileName(baseFileName, i, nofJobs);
+      if ( std::ifstream(fileName).good() ) fileNames.push_back(fileName);
+      else missing.push_back(fileName);
+    }
+    if ( fileNames.empty() || missing.empty() ) return true;
+
+    for ( const auto& fileName : missing ) {
+      G4cerr << "Missing " << fileName << G4endl;
+    }
+    return false;
+  }
+
+  // Check the event ranges of the jobs, they start the cluster-size sums
+  G4bool CheckJobs(const std::vector<G4String>& fileNames, G4int nofJobs,
+                   G4long& nofEvents)
+  {
+    B4::JobPartition::JobInfo first;
+    G4long nextEvent = 0;
+    for ( G4int i = 0; i < nofJobs; ++i ) {
+      std::ifstream file(fileNames[i]);
+      std::string line;
+      B4::JobPartition::JobInfo info;
+      if ( ! std::getline(file, line) || ! B4::JobPartition::ParseHeader(line, info) ) {
+        G4cerr << fileNames[i] << ": no job header" << G4endl;
+        return false;
+      }
+      if ( i == 0 ) {
+        first = info;
+        nextEvent = info.firstEvent;
+      }
+      if ( info.index != i || info.count != nofJobs ) {
+        G4cerr << fileNames[i] << ": job " << info.index << "/" << info.count
+               << " instead of " << i << "/" << nofJobs << G4endl;
+        return false;
+      }
+      if ( info.runID != first.runID || info.seed != first.seed ) {
+        G4cerr << fileNames[i] << ": run " << info.runID << " seed " << info.seed
+               << " differ from run " << first.runID << " seed " << first.seed
+               << " of job 0" << G4endl;
+        return false;
+      }
+      if ( info.firstEvent != nextEvent ) {
+        G4cerr << fileNames[i] << ": events start at " << info.firstEvent
+               << " instead of " << nextEvent << G4endl;
+        return false;
+      }
+      nextEvent = info.firstEvent + info.nofEvents;
+    }
+    nofEvents = nextEvent - first.firstEvent;
+    return true;
+  }
+
+  // Sum the histograms of the jobs into a new B4.root
+  G4bool MergeHistograms(const std::vector<G4String>& fileNames,
+                         const std::vector<G4String>& histogramNames,
+                         const G4String& outFileName)
+  {
+    auto reader = G4RootAnalysisReader::Instance();
+    std::map<G4String, std::unique_ptr<tools::histo::h1d>> sums;
+    for ( const auto& fileName : fileNames ) {
+      for ( const auto& name : histogramNames ) {
+        auto id = reader->ReadH1(name, fileName);
+        auto h1 = ( id >= 0 ) ? reader->GetH1(id, false) : nullptr;
+        if ( h1 == nullptr ) {
+          G4cerr << fileName << ": cannot read histogram " << name << G4endl;
+          return false;
+        }
+        auto& sum = sums[name];
+        if ( ! sum ) sum = std::make_unique<tools::histo::h1d>(*h1);
+        else sum->add(*h1);
+      }
+    }
+
+    // Book the sums like the jobs did and write them
+    auto analysisManager = G4RootAnalysisManager::Instance();
+    for ( const auto& name : histogramNames ) {
+      const auto& sum = *sums[name];
+      auto id = analysisManager->CreateH1(name, sum.title(), sum.axis().bins(),
+                                          sum.axis().lower_edge(),
+                                          sum.axis().upper_edge());
+      *analysisManager->GetH1(id) = sum;
+    }
+    analysisManager->OpenFile(outFileName);
+    analysisManager->Write();
+    analysisManager->CloseFile();
+    return true;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc,char** argv)
+{
+  // Evaluate arguments
+  //
+  if ( argc < 2 || argc > 3 ) {
+    PrintUsage();
+    return 1;
+  }
+  auto nofJobs = G4UIcommand::ConvertToInt(argv[1]);
+  G4String directory = ( argc > 2 ) ? argv[2] : ".";
+  if ( nofJobs < 2 ) {
+    PrintUsage();
+    return 1;
+  }
+
+  // Cluster-size sums, written by every job, fix the event ranges
+  std::vector<G4String> fileNames;
+  G4long nofEvents = 0;
+  if ( ! FindJobFiles(directory, "cluster_size_sums.txt", nofJobs, fileNames)
+       || fileNames.empty()
+       || ! CheckJobs(fileNames, nofJobs, nofEvents) ) {
+    G4cerr << "The jobs do not form one partitioned run, nothing merged." << G4endl;
+    return 1;
+  }
+
+  B4::ClusterSizeAccumulator clusterSizes;
+  for ( const auto& fileName : fileNames ) {
+    B4::ClusterSizeAccumulator jobClusterSizes;
+    if ( ! jobClusterSizes.ReadSums(fileName) ) {
+      G4cerr << fileName << ": cannot read the cluster-size sums" << G4endl;
+      return 1;
+    }
+    clusterSizes.Merge(jobClusterSizes);
+  }
+  if ( clusterSizes.GetNofEvents() > 0 ) {
+    clusterSizes.Write("cluster_size.txt");
+  }
+  G4cout << "Merged " << nofJobs << " jobs, " << nofEvents << " events" << G4endl
+         << "  cluster_size.txt: M1 = " << clusterSizes.GetM1()
+         << " +- " << clusterSizes.GetM1Error()
+         << "  F2 = " << clusterSizes.GetCumulative(2) << G4endl;
+
+  // Event tables, in global event ID order
+  for ( const G4String baseFileName : { "data.txt", "cells.txt", "braggcurve_data.txt" } ) {
+    if ( ! FindJobFiles(directory, baseFileName, nofJobs, fileNames) ) return 1;
+    if ( fileNames.empty() ) continue;
+
+    auto header = StripJobHeader(ReadHeader(fileNames.front()));
+    if ( ! B4::OutputShard::MergeTextFiles(fileNames, baseFileName, header) ) return 1;
+    G4cout << "  " << baseFileName << G4endl;
+  }
+
+  // Histograms
+  if ( ! FindJobFiles(directory, "B4.root", nofJobs, fileNames) ) return 1;
+  if ( ! fileNames.empty() ) {
+    if ( ! MergeHistograms(fileNames, { "ESphere", "LSphere" }, "B4.root") ) return 1;
+    G4cout << "  B4.root (histograms)" << G4endl;
+  }
+
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo.....
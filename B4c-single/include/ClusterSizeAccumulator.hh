@@ -0,0 +1,155 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ClusterSizeAccumulator.hh
+/// \brief Definition of the B4::ClusterSizeAccumulator class
+
+#ifndef B4ClusterSizeAccumulator_h
+#define B4ClusterSizeAccumulator_h 1
+
+#include "G4VAccumulable.hh"
+#include "globals.hh"
+
+#include <vector>
+
+namespace B4
+{
+
+/// Ionisation cluster-size distribution
+///
+/// Accumulates the number of events n(nu) and their sum of weights W(nu) per
+/// cluster size nu (number of ionisations in the sensitive detector) together
+/// with the running sums of w nu and w nu^2. It is registered to
+/// G4AccumulableManager, so the distributions of the workers are merged into
+/// the master's one at the end of the run.
+///
+/// The nanodosimetric quantities are derived from it:
+/// - P(nu) = W(nu) / W, W = sum of all weights (n(nu) / N without biasing)
+/// - M1 = sum nu P(nu), M2 = sum nu^2 P(nu)
+/// - F_k = sum_{nu >= k} P(nu), in particular F2
+///
+/// With weighted events (source biasing) the standard error of M1 is the one
+/// of the weighted mean, and GetM1Gain() compares it to the error an analog
+/// run with the same number of events would have.
+///
+/// The cluster size of an event with track weights differing from the event
+/// weight (splitting, roulette) is estimated and in general not an integer.
+/// Its weight is then shared between the two neighbouring cluster sizes in
+/// proportion to the distance, the event is counted in n(nu) at the nearest
+/// one; the moments use the estimated cluster size itself. M1 stays
+/// unbiased, but P(nu), M2 and F_k are then no longer the nanodosimetric
+/// distribution: such events are counted (GetNofEstimatedEvents()) and
+/// Write() flags these quantities as approximate.
+///
+/// WriteSums() and ReadSums() save and restore the accumulated sums
+/// themselves, the mergeJobs program merges those of several jobs.
+
+class ClusterSizeAccumulator : public G4VAccumulable
+{
+  public:
+    ClusterSizeAccumulator(const G4String& name = "ClusterSize");
+    ~ClusterSizeAccumulator() override = default;
+
+    // Add the cluster size of one event with its weight, estimated is true
+    // if the cluster size is estimated from track weighted counts
+    inline void Fill(G4double clusterSize, G4double weight = 1.,
+                     G4bool estimated = false);
+
+    // Methods from base class
+    void Merge(const G4VAccumulable& other) override;
+    void Reset() override;
+
+    G4long   GetNofEvents() const { return fNofEvents; }
+    G4double GetSumOfWeights() const { return fSumW; }
+    G4bool   IsWeighted() const { return fSumW != fNofEvents || fSumW2 != fNofEvents; }
+    G4long   GetNofEstimatedEvents() const { return fNofEstimatedEvents; }
+    G4bool   IsExact() const { return fNofEstimatedEvents == 0; }  // P(nu), M2, F_k
+    G4double GetNofEffectiveEvents() const;  // (sum w)^2 / sum w^2
+    G4int    GetMaxClusterSize() const { return G4int(fCounts.size()) - 1; }
+    G4long   GetCount(G4int clusterSize) const;
+    G4double GetProbability(G4int clusterSize) const;
+    G4double GetM1() const;
+    G4double GetM2() const;
+    G4double GetM1Error() const;             // standard error of M1
+    G4double GetM1Gain() const;              // analog / weighted variance of M1
+    G4double GetCumulative(G4int k) const;   // F_k
+
+    // Write the distribution and its moments as text (master only),
+    // starting the file with header
+    void Write(const G4String& fileName, const G4String& header = "") const;
+
+    // Write/read the raw sums at full precision, so that partial
+    // distributions (e.g. of several jobs) can be merged exactly
+    void WriteSums(const G4String& fileName, const G4String& header = "") const;
+    G4bool ReadSums(const G4String& fileName);
+
+  private:
+    std::vector<G4long> fCounts;    // n(nu), grown on demand
+    std::vector<G4double> fWeights; // W(nu), same size as fCounts
+    G4long   fNofEvents = 0;
+    G4long   fNofEstimatedEvents = 0;  // events with an estimated cluster size
+    G4double fSumW = 0.;         // sum of w
+    G4double fSumW2 = 0.;        // sum of w^2
+    G4double fSum = 0.;          // sum of w nu
+    G4double fSum2 = 0.;         // sum of w nu^2
+    G4double fSumW2Nu = 0.;      // sum of w^2 nu
+    G4double fSumW2Nu2 = 0.;     // sum of w^2 nu^2
+};
+
+// inline functions
+
+inline void ClusterSizeAccumulator::Fill(G4double clusterSize, G4double weight,
+                                         G4bool estimated)
+{
+  if ( clusterSize < 0. ) return;
+  const auto lower = G4int(clusterSize);
+  const G4double fraction = clusterSize - lower;
+  const auto upper = fraction > 0. ? lower + 1 : lower;
+  if ( upper >= G4int(fCounts.size()) ) {
+    fCounts.resize(upper + 1, 0);
+    fWeights.resize(upper + 1, 0.);
+  }
+  ++fCounts[fraction < 0.5 ? lower : upper];
+  fWeights[lower] += (1. - fraction) * weight;
+  if ( fraction > 0. ) fWeights[upper] += fraction * weight;
+  ++fNofEvents;
+  if ( estimated ) ++fNofEstimatedEvents;
+
+  const G4double nu = clusterSize;
+  const G4double weight2 = weight * weight;
+  fSumW += weight;
+  fSumW2 += weight2;
+  fSum += weight * nu;
+  fSum2 += weight * nu * nu;
+  fSumW2Nu += weight2 * nu;
+  fSumW2Nu2 += weight2 * nu * nu;
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
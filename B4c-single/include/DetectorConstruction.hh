@@ -33,18 +33,31 @@
 #include "G4VUserDetectorConstruction.hh"
 #include "globals.hh"
 
+#include <map>
+
 class G4VPhysicalVolume;
 class G4GlobalMagFieldMessenger;
 
 namespace B4c
 {
 
+class DetectorMessenger;
+
 /// Detector construction class to define materials and geometry.
 ///
 /// In ConstructSDandField() sensitive detectors of CalorimeterSD type
 /// are created.
 /// In addition a transverse uniform magnetic field is defined
 /// via G4GlobalMagFieldMessenger class.
+/// The sensitive detectors are wrapped in the "Nanodosimetry" G4Region,
+/// extended by a margin (/microyz/det/regionMargin), in which PhysicsList
+/// can switch to Geant4-DNA models (/microyz/phys/dnaRegion).
+/// The region has its own production cut (/microyz/det/regionCut), so the
+/// world can be run with coarse cuts (/run/setCut).
+/// G4UserLimits (max step, max track length, min kinetic energy) can be
+/// attached to any logical volume by name via the /microyz/limits/ commands,
+/// they are applied by G4StepLimiter and G4UserSpecialCuts of PhysicsList.
+/// The material table is only printed with /microyz/det/verbose 1.
 
 class DetectorConstruction : public G4VUserDetectorConstruction
 {
@@ -56,18 +69,42 @@ class DetectorConstruction : public G4VUserDetectorConstruction
     G4VPhysicalVolume* Construct() override;
     void ConstructSDandField() override;
 
+    // Set methods
+    void SetRegionMargin(G4double margin);
+    void SetRegionCut(G4double cut);
+    void SetVerboseLevel(G4int level);
+
+    // User limits of a logical volume (/microyz/limits/ commands)
+    void SetMaxStep(const G4String& volume, G4double maxStep);
+    void SetMaxTrackLength(const G4String& volume, G4double maxTrackLength);
+    void SetMinKineticEnergy(const G4String& volume, G4double minKineticEnergy);
+
   private:
+    struct VolumeLimits
+    {
+      G4double fMaxStep = DBL_MAX;
+      G4double fMaxTrackLength = DBL_MAX;
+      G4double fMinKineticEnergy = 0.;
+    };
+
     // Methods
     //
     void DefineMaterials();
     G4VPhysicalVolume* DefineVolumes();
+    void ApplyUserLimits();
 
     // Data members
     //
     static G4ThreadLocal G4GlobalMagFieldMessenger*  fMagFieldMessenger;
                                       // magnetic field messenger
 
+    DetectorMessenger* fMessenger = nullptr;
+
     G4bool fCheckOverlaps = true; // option to activate checking of volumes overlaps
+    G4double fRegionMargin;       // margin of the Nanodosimetry region around the SD
+    G4double fRegionCut;          // production cut in the Nanodosimetry region
+    G4int  fVerboseLevel = 0;     // >= 1 prints the material table
+    std::map<G4String, VolumeLimits> fVolumeLimits; // user limits per logical volume
 //    G4int  fNofLayers = -1;     // number of layers
 };
 
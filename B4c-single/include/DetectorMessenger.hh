@@ -0,0 +1,81 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file DetectorMessenger.hh
+/// \brief Definition of the B4c::DetectorMessenger class
+
+#ifndef B4cDetectorMessenger_h
+#define B4cDetectorMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAnInteger;
+
+namespace B4c
+{
+
+class DetectorConstruction;
+
+/// Messenger of the detector construction
+///
+/// /microyz/det/ commands configure the detector construction,
+/// /microyz/limits/ commands attach user limits to logical volumes.
+
+class DetectorMessenger : public G4UImessenger
+{
+  public:
+    DetectorMessenger(DetectorConstruction* detConstruction);
+    ~DetectorMessenger() override;
+
+    void SetNewValue(G4UIcommand* command, G4String newValue) override;
+
+  private:
+    G4UIcommand* MakeLimitCommand(const char* path, const char* guidance,
+                                  const char* range,
+                                  const char* defaultUnit);
+
+    DetectorConstruction*       fDetConstruction = nullptr;
+
+    G4UIdirectory*              fDetDir = nullptr;
+    G4UIcmdWithADoubleAndUnit*  fRegionMarginCmd = nullptr;
+    G4UIcmdWithADoubleAndUnit*  fRegionCutCmd = nullptr;
+    G4UIcmdWithAnInteger*       fVerboseCmd = nullptr;
+
+    G4UIdirectory*              fLimitsDir = nullptr;
+    G4UIcommand*                fMaxStepCmd = nullptr;
+    G4UIcommand*                fMaxTrackLengthCmd = nullptr;
+    G4UIcommand*                fMinKineticEnergyCmd = nullptr;
+};
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -40,6 +40,12 @@
 #include "globals.hh"
 
 class PhysicsListMessenger;
+class G4EmDNAPhysicsActivator;
+
+namespace B4
+{
+class PhysicsTableCache;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -53,17 +59,26 @@ class PhysicsList: public G4VModularPhysicsList
     virtual void ConstructParticle();
 
     void AddPhysicsList(const G4String& name);
+    void SetDnaRegion(const G4String& option);
+    void SetTableCache(const G4String& directory);
     virtual void ConstructProcess();
 
     void AddTrackingCut();
     void AddMaxStepSize();
 
+    // Print the models of the region Nanodosimetry (master, after the
+    // physics tables are built), warn if no Geant4-DNA model is attached
+    void CheckDnaRegion() const;
+
   private:
 
     G4String                      fEmName;
+    G4String                      fDnaRegionOption = "none"; // Geant4-DNA option in region Nanodosimetry
     G4VPhysicsConstructor*        fEmPhysicsList;
+    G4EmDNAPhysicsActivator*      fDnaActivator;   // Geant4-DNA models in region Nanodosimetry
 //  G4VModularPhysicsList*	  fEmPhysicsList;
     PhysicsListMessenger*         fMessenger;
+    B4::PhysicsTableCache*        fTableCache;     // owned by the G4StateManager
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
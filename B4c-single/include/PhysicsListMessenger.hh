@@ -60,6 +60,8 @@ class PhysicsListMessenger: public G4UImessenger
     
     G4UIdirectory*             fPhysDir;        
     G4UIcmdWithAString*        fListCmd;
+    G4UIcmdWithAString*        fDnaRegionCmd;
+    G4UIcmdWithAString*        fTableCacheCmd;
     
 };
 
@@ -0,0 +1,103 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ProgressReporter.hh
+/// \brief Definition of the B4::ProgressReporter class
+
+#ifndef B4ProgressReporter_h
+#define B4ProgressReporter_h 1
+
+#include "globals.hh"
+
+#include <atomic>
+#include <chrono>
+
+namespace B4
+{
+
+class ConcurrentHistogram;
+
+/// Time based progress report of the run
+///
+/// One reporter is shared by all threads (see SharedRunData), the finished
+/// events of all threads are counted in an atomic counter. Whichever thread
+/// finishes an event after the report interval has passed prints one line
+/// with the number of events, the event rate and the estimated time to the
+/// end of the run, so the console output no longer grows with the number
+/// of events.
+///
+/// With SetLiveClusterSizes() the line also gives M1 and F2 of the cluster
+/// sizes of the events of all threads so far, read from the shared
+/// ConcurrentHistogram without stopping the other threads.
+///
+/// Verbose levels (/microyz/progress/verbose):
+/// - 0 : no progress output
+/// - 1 : progress line every interval and throughput at the end of run
+/// - 2 : in addition the per-event summary of EventAction
+
+class ProgressReporter
+{
+  public:
+    ProgressReporter() = default;
+    ~ProgressReporter() = default;
+
+    void  SetInterval(G4double seconds) { fInterval = seconds; }
+    void  SetVerboseLevel(G4int level) { fVerboseLevel = level; }
+    G4int GetVerboseLevel() const { return fVerboseLevel; }
+
+    // Cluster-size distribution of all threads reported with the progress
+    void SetLiveClusterSizes(const ConcurrentHistogram* histogram)
+      { fLiveClusterSizes = histogram; }
+
+    // Start the clock for the given number of events (master)
+    void BeginOfRun(G4int nofEvents);
+
+    // Count one finished event of the calling thread
+    void EventDone();
+
+    // Print the throughput of the entire run (master)
+    void EndOfRun() const;
+
+  private:
+    void Report(G4long nofEventsDone, G4double elapsed) const;
+
+    G4double fInterval = 10.;  // in seconds
+    G4int    fVerboseLevel = 1;
+    const ConcurrentHistogram* fLiveClusterSizes = nullptr;
+
+    // Counted by all threads of the run, times in clock ticks
+    using Ticks = std::chrono::steady_clock::rep;
+    std::atomic<G4long> fEventsDone { 0 };
+    std::atomic<G4long> fTotalEvents { 0 };
+    std::atomic<Ticks>  fStartTime { 0 };
+    std::atomic<Ticks>  fNextReport { 0 };  // since start
+};
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
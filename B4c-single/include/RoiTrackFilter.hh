@@ -0,0 +1,112 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file RoiTrackFilter.hh
+/// \brief Definition of the B4::RoiTrackFilter class
+
+#ifndef B4RoiTrackFilter_h
+#define B4RoiTrackFilter_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <vector>
+
+class G4Material;
+class G4ParticleDefinition;
+class G4Track;
+
+namespace B4
+{
+
+/// Decides whether a track can still reach the region of interest.
+///
+/// The region of interest is the bounding box of the root volume of the
+/// "Nanodosimetry" region (DetectorConstruction), which contains the
+/// sensitive detectors. Outside of it a track is rejected if
+/// - it is an electron whose CSDA range, times a safety factor, is shorter
+///   than its distance to the box, or
+/// - it is a heavy charged particle moving away from the box, so that
+///   neither the particle nor the delta electrons it can produce (maximum
+///   energy transfer, CSDA range) can reach the box.
+/// Photons, neutrons and positrons are never rejected.
+///
+/// The electron CSDA range is tabulated in the material of the region's root
+/// volume from G4EmCalculator::ComputeTotalDEDX(). Without continuous energy
+/// loss of electrons in the physics list (e.g. Geant4-DNA everywhere) the
+/// range is infinite and no track is rejected.
+/// Initialise() has to be called at the start of each run, in each thread.
+
+class RoiTrackFilter
+{
+  public:
+    RoiTrackFilter() = default;
+    ~RoiTrackFilter() = default;
+
+    void SetEnabled(G4bool value) { fEnabled = value; }
+    G4bool IsEnabled() const { return fEnabled && fInitialised; }
+
+    // Multiplies the ranges before they are compared with the distances
+    void SetRangeSafety(G4double factor) { fRangeSafety = factor; }
+    G4double GetRangeSafety() const { return fRangeSafety; }
+
+    // Locate the region of interest and tabulate the electron range
+    void Initialise();
+
+    // False if the track can not reach the region of interest any more
+    G4bool CanReachRoi(const G4Track* track) const;
+
+    // Path length a rejected track would still have been tracked: the CSDA
+    // range of an electron, 0 for other particles (not tabulated)
+    G4double GetResidualRange(const G4Track* track) const;
+
+    G4ThreeVector GetRoiCenter() const { return fCenter; }
+    G4ThreeVector GetRoiHalfSize() const { return fHalfSize; }
+
+  private:
+    G4double GetElectronRange(G4double energy) const;
+
+    G4bool   fEnabled = false;
+    G4bool   fInitialised = false;
+    G4double fRangeSafety = 1.2;
+
+    G4ThreeVector fCenter;
+    G4ThreeVector fHalfSize;
+    const G4Material* fMaterial = nullptr;
+    const G4ParticleDefinition* fElectron = nullptr;
+
+    // Electron CSDA range on a logarithmic energy grid
+    std::vector<G4double> fEnergies;
+    std::vector<G4double> fRanges;
+    G4double fLogEmin = 0.;
+    G4double fInvLogStep = 0.;
+};
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,81 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SharedRunData.hh
+/// \brief Definition of the B4::SharedRunData class
+
+#ifndef B4SharedRunData_h
+#define B4SharedRunData_h 1
+
+#include "ConcurrentHistogram.hh"
+#include "ConvergenceMonitor.hh"
+#include "ProgressReporter.hh"
+#include "globals.hh"
+
+namespace B4
+{
+
+/// State of the run shared by the actions of all threads
+///
+/// It is owned by ActionInitialization and handed to the RunData of every
+/// thread, so the threads fill and read the same objects during the run:
+/// - the cluster sizes of the events of all threads (ConcurrentHistogram),
+///   read by the progress report,
+/// - the convergence sums of the early stop (ConvergenceMonitor),
+/// - the count of finished events of the progress report (ProgressReporter).
+///
+/// The master resets it in BeginOfRunAction(), before the workers start.
+/// The convergence and progress commands are only applied on the master.
+
+class SharedRunData
+{
+  public:
+    SharedRunData();
+    ~SharedRunData() = default;
+
+    // Reset for a run of the given number of events (master)
+    void BeginOfRun(G4int nofEvents);
+
+    // Cluster-size distribution of all threads, readable during the run
+    ConcurrentHistogram& GetLiveClusterSizes() { return fLiveClusterSizes; }
+
+    // Convergence based early stop of the run
+    ConvergenceMonitor& GetConvergenceMonitor() { return fConvergenceMonitor; }
+
+    // Progress report of the run
+    ProgressReporter& GetProgressReporter() { return fProgressReporter; }
+
+  private:
+    ConcurrentHistogram fLiveClusterSizes;
+    ConvergenceMonitor fConvergenceMonitor;
+    ProgressReporter fProgressReporter;
+};
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,174 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ConcurrentHistogram.cc
+/// \brief Implementation of the B4::ConcurrentHistogram class
+
+#include "ConcurrentHistogram.hh"
+
+#include "G4RunManager.hh"
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  // Add to a sum which other threads may add to as well, the rows are
+  // written by their own thread, so the exchange rarely has to be repeated
+  void AtomicAdd(std::atomic<G4double>& sum, G4double value)
+  {
+    auto old = sum.load(std::memory_order_relaxed);
+    while ( ! sum.compare_exchange_weak(old, old + value,
+                                        std::memory_order_relaxed) ) {}
+  }
+}
+
+namespace B4
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ConcurrentHistogram::Line::Line()
+{
+  for ( auto& sum : value ) sum.store(0., std::memory_order_relaxed);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ConcurrentHistogram::ConcurrentHistogram(G4int nofBins, G4double xmin, G4double xmax)
+ : fNofBins(std::max(nofBins, 0)),
+   fXmin(xmin),
+   fXmax(xmax)
+{
+  auto nofValues = kNofSums + ( fNofBins > 0 ? fNofBins + 2 : 0 );
+  fLinesPerRow = ( nofValues + Line::kSize - 1 ) / Line::kSize;
+  fLines = std::vector<Line>(fNofRows * fLinesPerRow);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ConcurrentHistogram::Reset()
+{
+  // Row 0 for the master (and the sequential mode), one row per worker
+  fNofRows = G4RunManager::GetRunManager()->GetNumberOfThreads() + 1;
+  fLines = std::vector<Line>(fNofRows * fLinesPerRow);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ConcurrentHistogram::Fill(G4double x, G4double weight)
+{
+  // Threads beyond the rows share them, the additions stay atomic
+  auto threadID = G4Threading::G4GetThreadId();
+  auto row = ( threadID < 0 || fNofRows < 2 ) ? 0 : 1 + threadID % ( fNofRows - 1 );
+
+  const G4double weight2 = weight * weight;
+  AtomicAdd(Value(row, kNofEntries), 1.);
+  AtomicAdd(Value(row, kSumW), weight);
+  AtomicAdd(Value(row, kSumW2), weight2);
+  AtomicAdd(Value(row, kSumWX), weight * x);
+  AtomicAdd(Value(row, kSumWX2), weight * x * x);
+  AtomicAdd(Value(row, kSumW2X), weight2 * x);
+  AtomicAdd(Value(row, kSumW2X2), weight2 * x * x);
+
+  if ( fNofBins == 0 ) return;
+
+  G4int bin = 0;
+  if ( x >= fXmax ) {
+    bin = fNofBins + 1;
+  }
+  else if ( x >= fXmin ) {
+    bin = 1 + G4int(fNofBins * ( x - fXmin ) / ( fXmax - fXmin ));
+    if ( bin > fNofBins ) bin = fNofBins;
+  }
+  AtomicAdd(Value(row, kNofSums + bin), weight);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ConcurrentHistogram::Snapshot ConcurrentHistogram::GetSnapshot() const
+{
+  Snapshot snapshot;
+  G4double sums[kNofSums] = {};
+  snapshot.bins.assign(fNofBins > 0 ? fNofBins + 2 : 0, 0.);
+
+  for ( G4int row = 0; row < fNofRows; ++row ) {
+    for ( G4int i = 0; i < kNofSums; ++i ) {
+      sums[i] += Value(row, i).load(std::memory_order_relaxed);
+    }
+    for ( G4int bin = 0; bin < G4int(snapshot.bins.size()); ++bin ) {
+      snapshot.bins[bin] += Value(row, kNofSums + bin).load(std::memory_order_relaxed);
+    }
+  }
+
+  snapshot.nofEntries = G4long(sums[kNofEntries]);
+  snapshot.sumW = sums[kSumW];
+  snapshot.sumW2 = sums[kSumW2];
+  snapshot.sumWX = sums[kSumWX];
+  snapshot.sumWX2 = sums[kSumWX2];
+  snapshot.sumW2X = sums[kSumW2X];
+  snapshot.sumW2X2 = sums[kSumW2X2];
+  return snapshot;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ConcurrentHistogram::Snapshot::GetMean() const
+{
+  return sumW != 0. ? sumWX / sumW : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ConcurrentHistogram::Snapshot::GetMeanError() const
+{
+  // Variance of the weighted mean, sum w^2 (x - mean)^2 / (sum w)^2,
+  // as ClusterSizeAccumulator::GetM1Error()
+  if ( nofEntries < 2 || sumW == 0. ) return 0.;
+  auto mean = GetMean();
+  auto variance = (sumW2X2 - 2. * mean * sumW2X + mean * mean * sumW2)
+                  / (sumW * sumW) * nofEntries / (nofEntries - 1);
+  return variance > 0. ? std::sqrt(variance) : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::atomic<G4double>& ConcurrentHistogram::Value(G4int row, G4int index)
+{
+  return fLines[row * fLinesPerRow + index / Line::kSize].value[index % Line::kSize];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const std::atomic<G4double>& ConcurrentHistogram::Value(G4int row, G4int index) const
+{
+  return fLines[row * fLinesPerRow + index / Line::kSize].value[index % Line::kSize];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
@@ -28,13 +28,18 @@
 /// \brief Implementation of the B4c::DetectorConstruction class
 
 #include "DetectorConstruction.hh"
+#include "DetectorMessenger.hh"
 #include "CalorimeterSD.hh"
 #include "G4Material.hh"
 #include "G4NistManager.hh"
 
 #include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
 #include "G4PVPlacement.hh"
 #include "G4PVReplica.hh"
+#include "G4Region.hh"
+#include "G4ProductionCuts.hh"
+#include "G4UserLimits.hh"
 #include "G4GlobalMagFieldMessenger.hh"
 #include "G4AutoDelete.hh"
 
@@ -45,11 +50,15 @@
 
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
 
 #include "G4Tubs.hh"
 #include "G4Sphere.hh"
 #include "G4Box.hh"
 
+#include <algorithm>
+#include <cmath>
+
 
 namespace B4c
 {
@@ -62,13 +71,61 @@ G4GlobalMagFieldMessenger* DetectorConstruction::fMagFieldMessenger = nullptr;
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 DetectorConstruction::DetectorConstruction()
+ : fRegionMargin(1 * um),
+   fRegionCut(0.1 * nm)
 {
+  fMessenger = new DetectorMessenger(this);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 DetectorConstruction::~DetectorConstruction()
 {
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetRegionMargin(G4double margin)
+{
+  fRegionMargin = margin;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetRegionCut(G4double cut)
+{
+  fRegionCut = cut;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetVerboseLevel(G4int level)
+{
+  fVerboseLevel = level;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetMaxStep(const G4String& volume, G4double maxStep)
+{
+  fVolumeLimits[volume].fMaxStep = maxStep;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetMaxTrackLength(const G4String& volume,
+                                             G4double maxTrackLength)
+{
+  fVolumeLimits[volume].fMaxTrackLength = maxTrackLength;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetMinKineticEnergy(const G4String& volume,
+                                               G4double minKineticEnergy)
+{
+  fVolumeLimits[volume].fMinKineticEnergy = minKineticEnergy;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -91,8 +148,10 @@ void DetectorConstruction::DefineMaterials()
   nistManager->FindOrBuildMaterial("G4_WATER");
   nistManager->FindOrBuildMaterial("G4_LITHIUM_FLUORIDE");
 
-  // Print materials
-  G4cout << *(G4Material::GetMaterialTable()) << G4endl;
+  // Print materials (/microyz/det/verbose 1)
+  if ( fVerboseLevel > 0 ) {
+    G4cout << *(G4Material::GetMaterialTable()) << G4endl;
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -187,12 +246,59 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
 			"SensitiveDetector");	// its name
 
 
+  //
+  // Nanodosimetry region
+  //
+  // Water envelope of the SD extended by the region margin
+  // (/microyz/det/regionMargin), as far as the world allows.
+  // Geant4-DNA models are activated in this region by PhysicsList
+  // (/microyz/phys/dnaRegion), condensed-history physics is used elsewhere.
+  G4double env_hx = std::min(SD_sizeX/2 + fRegionMargin, worldRadius/std::sqrt(2.));
+  G4double env_hy = std::min(SD_sizeY/2 + fRegionMargin, worldRadius/std::sqrt(2.));
+  G4double env_hz = std::min(SD_sizeZ/2 + fRegionMargin, worldHeight/2);
+
+  auto envelopeS
+	= new G4Box("NanodosimetryEnvelope",	// its name
+			env_hx,			// its half length in X
+			env_hy,			// its half length in Y
+			env_hz);		// its half length in Z
+
+  auto envelopeLV
+	= new G4LogicalVolume(
+			envelopeS,		// its solid
+			worldMaterial,		// its material
+			"NanodosimetryEnvelope");	// its name
+
+  new G4PVPlacement(
+		0, 				// its rotation
+		G4ThreeVector(0., 0., 0.),	// its placement
+		envelopeLV,			// its logical volume
+		"NanodosimetryEnvelope",	// its name
+		worldLV,			// its mother volume
+		false,				// no boolean operation
+		0,				// copy number
+		fCheckOverlaps);		// checking overlaps
+
+  auto nanodosimetryRegion = new G4Region("Nanodosimetry");
+  envelopeLV->SetRegion(nanodosimetryRegion);
+  nanodosimetryRegion->AddRootLogicalVolume(envelopeLV);
+
+  // Fine production cut only where we score, the world keeps /run/setCut
+  auto regionCuts = new G4ProductionCuts();
+  regionCuts->SetProductionCut(fRegionCut);
+  nanodosimetryRegion->SetProductionCuts(regionCuts);
+
+  G4cout << "Nanodosimetry region: " << G4BestUnit(2*env_hx, "Length")
+         << " x " << G4BestUnit(2*env_hy, "Length")
+         << " x " << G4BestUnit(2*env_hz, "Length")
+         << ", cut " << G4BestUnit(fRegionCut, "Length") << G4endl;
+
   new G4PVPlacement(
 		0, 				// its rotation
 		G4ThreeVector(0., 0., 0.),	// its placement
 		SensitiveDetectorLV,		// its logical volume
 		"SensitiveDetector",		// its name
-		worldLV,			// its mother volume
+		envelopeLV,			// its mother volume
 		false,				// no boolean operation
 		0,				// copy number
 		fCheckOverlaps);		// checking overlaps
@@ -203,6 +309,11 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
  // worldLV->SetVisAttributes (G4VisAttributes::GetInvisible());
 
 
+  //
+  // User limits (/microyz/limits/ commands)
+  //
+  ApplyUserLimits();
+
   //
   // Always return the physical World
   //
@@ -211,6 +322,41 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void DetectorConstruction::ApplyUserLimits()
+{
+  // The limits only act on the particles with G4StepLimiter and
+  // G4UserSpecialCuts processes (electrons, see PhysicsList), they are not
+  // propagated to the daughter volumes
+  for ( const auto& [volume, limits] : fVolumeLimits ) {
+    auto logicalVolume = G4LogicalVolumeStore::GetInstance()->GetVolume(volume, false);
+    if ( logicalVolume == nullptr ) {
+      G4ExceptionDescription msg;
+      msg << "Logical volume " << volume << " not found, user limits ignored.";
+      G4Exception("DetectorConstruction::ApplyUserLimits()",
+        "MyCode0011", JustWarning, msg);
+      continue;
+    }
+
+    logicalVolume->SetUserLimits(
+      new G4UserLimits(limits.fMaxStep, limits.fMaxTrackLength, DBL_MAX,
+                       limits.fMinKineticEnergy));
+
+    G4cout << "User limits of " << volume << ":";
+    if ( limits.fMaxStep < DBL_MAX ) {
+      G4cout << " max step " << G4BestUnit(limits.fMaxStep, "Length");
+    }
+    if ( limits.fMaxTrackLength < DBL_MAX ) {
+      G4cout << " max track length " << G4BestUnit(limits.fMaxTrackLength, "Length");
+    }
+    if ( limits.fMinKineticEnergy > 0. ) {
+      G4cout << " min kinetic energy " << G4BestUnit(limits.fMinKineticEnergy, "Energy");
+    }
+    G4cout << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void DetectorConstruction::ConstructSDandField()
 {
   // G4SDManager::GetSDMpointer()->SetVerboseLevel(1);
@@ -0,0 +1,315 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file JobPartition.cc
+/// \brief Implementation of the B4::JobPartition class
+
+#include "JobPartition.hh"
+
+#include "G4EventManager.hh"
+#include "G4Run.hh"
+#include "G4RunManager.hh"
+#include "G4TrackingManager.hh"
+#include "G4UImanager.hh"
+#include "Randomize.hh"
+
+#include <cstdint>
+#include <sstream>
+
+namespace
+{
+  // Configuration of the job (--job option, /microyz/random commands)
+  G4int  jobIndex = 0;
+  G4int  jobCount = 0;
+  G4long jobSeed = 1;
+  G4bool perEventSeeding = true;
+
+  // Event range of the current run, set by the master
+  G4int  runID = 0;
+  G4long firstEvent = 0;
+  G4long nofEvents = 0;
+  G4long nofRunEvents = 0;     // events of the run over all the jobs
+  G4long eventsBefore = 0;     // global events of the previous runs
+  G4long nextFirstEvent = -1;  // set by BeamOn() for the run it starts
+  G4long nextRunEvents = 0;
+
+  // Global event IDs re-simulated by Replay(), empty otherwise
+  std::vector<G4long> replayEvents;
+
+  // SplitMix64 generator, advances the state and returns the next value
+  std::uint64_t SplitMix64(std::uint64_t& state)
+  {
+    auto z = ( state += 0x9e3779b97f4a7c15ULL );
+    z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+    z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+    return z ^ ( z >> 31 );
+  }
+}
+
+namespace B4
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool JobPartition::Configure(const G4String& spec)
+{
+  // "i/N" with 0 <= i < N
+  std::istringstream in(spec);
+  G4int index = -1;
+  G4int count = 0;
+  char slash = 0;
+  if ( ! ( in >> index >> slash >> count ) || slash != '/' ) return false;
+  if ( ! ( in >> std::ws ).eof() ) return false;
+  if ( count < 1 || index < 0 || index >= count ) return false;
+
+  jobIndex = index;
+  jobCount = count;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool JobPartition::IsEnabled()
+{
+  return jobCount > 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int JobPartition::GetIndex()
+{
+  return jobIndex;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int JobPartition::GetCount()
+{
+  return jobCount;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void JobPartition::SetSeed(G4long seed)
+{
+  jobSeed = seed;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4long JobPartition::GetSeed()
+{
+  return jobSeed;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void JobPartition::SetPerEventSeeding(G4bool value)
+{
+  perEventSeeding = value;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool JobPartition::IsPerEventSeeding()
+{
+  return perEventSeeding || IsEnabled();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void JobPartition::BeamOn(G4long nofTotalEvents)
+{
+  // Job i simulates the events [i T / N, (i+1) T / N) of the total T,
+  // the first jobs get one event less when N does not divide T
+  G4long first = 0;
+  G4long last = nofTotalEvents;
+  if ( IsEnabled() ) {
+    first = nofTotalEvents * jobIndex / jobCount;
+    last = nofTotalEvents * ( jobIndex + 1 ) / jobCount;
+  }
+
+  nextFirstEvent = first;
+  nextRunEvents = nofTotalEvents;
+  G4RunManager::GetRunManager()->BeamOn(G4int(last - first));
+  nextFirstEvent = -1;
+  nextRunEvents = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void JobPartition::Replay(const std::vector<G4long>& eventIDs,
+                          G4int verboseLevel)
+{
+  if ( eventIDs.empty() ) return;
+
+  if ( ! IsPerEventSeeding() ) {
+    G4ExceptionDescription msg;
+    msg << "Per-event seeding is off, the replayed events will not" << G4endl
+        << "reproduce those of the run (/microyz/random/perEventSeeds true).";
+    G4Exception("JobPartition::Replay()",
+      "MyCode0017", JustWarning, msg);
+  }
+
+  // The workers inherit the tracking verbose level at the start of the run
+  auto trackingManager =
+    G4EventManager::GetEventManager()->GetTrackingManager();
+  auto savedVerboseLevel = trackingManager->GetVerboseLevel();
+  auto uiManager = G4UImanager::GetUIpointer();
+  uiManager->ApplyCommand("/tracking/verbose " + std::to_string(verboseLevel));
+
+  replayEvents = eventIDs;
+  G4RunManager::GetRunManager()->BeamOn(G4int(eventIDs.size()));
+  replayEvents.clear();
+
+  uiManager->ApplyCommand(
+    "/tracking/verbose " + std::to_string(savedVerboseLevel));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool JobPartition::IsReplaying()
+{
+  return ! replayEvents.empty();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void JobPartition::BeginOfRun(const G4Run* run)
+{
+  runID = run->GetRunID();
+  nofEvents = run->GetNumberOfEventToBeProcessed();
+
+  // Range given by BeamOn(), otherwise every job runs the requested events.
+  // With per-event seeding the global event IDs continue over the runs,
+  // so that the runs of a macro do not repeat the same events.
+  G4long offset = 0;
+  if ( nextFirstEvent >= 0 ) {
+    offset = nextFirstEvent;
+    nofRunEvents = nextRunEvents;
+  }
+  else {
+    offset = IsEnabled() ? jobIndex * nofEvents : 0;
+    nofRunEvents = IsEnabled() ? jobCount * nofEvents : nofEvents;
+  }
+  firstEvent = ( IsPerEventSeeding() ? eventsBefore : 0 ) + offset;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void JobPartition::EndOfRun()
+{
+  // A replay re-simulates events of the previous runs
+  if ( IsReplaying() ) return;
+
+  eventsBefore += nofRunEvents;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4long JobPartition::GetGlobalEventID(G4int eventID)
+{
+  if ( IsReplaying() ) return replayEvents[eventID];
+
+  return firstEvent + eventID;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void JobPartition::SeedEvent(G4int eventID)
+{
+  if ( ! IsPerEventSeeding() ) return;
+
+  // Chain the master seed and the global event ID through SplitMix64,
+  // the engine gets two non-zero 30 bit seeds. The thread, the run and
+  // the job do not enter, an event is reproduced wherever it is simulated.
+  std::uint64_t state = jobSeed;
+  state = SplitMix64(state) ^ std::uint64_t(GetGlobalEventID(eventID));
+  long seeds[3] = { long( SplitMix64(state) >> 34 ) + 1,
+                    long( SplitMix64(state) >> 34 ) + 1, 0 };
+  G4Random::setTheSeeds(seeds);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String JobPartition::FileName(const G4String& baseFileName)
+{
+  if ( IsReplaying() ) {
+    // data.txt --> data_replay.txt
+    auto dot = baseFileName.find_last_of('.');
+    if ( dot == std::string::npos ) return baseFileName + "_replay";
+    return baseFileName.substr(0, dot) + "_replay" + baseFileName.substr(dot);
+  }
+
+  return FileName(baseFileName, jobIndex, jobCount);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String JobPartition::FileName(const G4String& baseFileName,
+                                G4int index, G4int count)
+{
+  if ( count < 2 ) return baseFileName;
+
+  // data.txt --> data_job3of8.txt
+  auto suffix = "_job" + std::to_string(index) + "of" + std::to_string(count);
+  auto dot = baseFileName.find_last_of('.');
+  if ( dot == std::string::npos ) return baseFileName + suffix;
+  return baseFileName.substr(0, dot) + suffix + baseFileName.substr(dot);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String JobPartition::Header()
+{
+  if ( jobCount < 2 || IsReplaying() ) return "";
+
+  std::ostringstream header;
+  header << "# job " << jobIndex << "/" << jobCount
+         << " run " << runID
+         << " events " << firstEvent << " " << nofEvents
+         << " seed " << jobSeed << "\n";
+  return header.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool JobPartition::ParseHeader(const std::string& line, JobInfo& info)
+{
+  std::istringstream in(line);
+  std::string hash, job, run, events, seed;
+  char slash = 0;
+  in >> hash >> job >> info.index >> slash >> info.count
+     >> run >> info.runID
+     >> events >> info.firstEvent >> info.nofEvents
+     >> seed >> info.seed;
+  return ! in.fail() && hash == "#" && job == "job" && slash == '/'
+         && run == "run" && events == "events" && seed == "seed";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
@@ -0,0 +1,225 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file OutputShard.cc
+/// \brief Implementation of the B4::OutputShard class
+
+#include "OutputShard.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <queue>
+#include <string>
+#include <utility>
+
+namespace
+{
+  // Shards opened during the run, per base file name, with their thread ID
+  G4Mutex shardMutex = G4MUTEX_INITIALIZER;
+  std::map<G4String, std::vector<std::pair<G4int, G4String>>> shardRegistry;
+}
+
+namespace B4
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OutputShard::OutputShard(std::size_t bufferSize)
+ : fBuffer(bufferSize)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OutputShard::~OutputShard()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String OutputShard::ShardFileName(const G4String& baseFileName, G4int threadID)
+{
+  // data.txt --> data_t3.txt
+  auto suffix = "_t" + std::to_string(threadID);
+  auto dot = baseFileName.find_last_of('.');
+  if ( dot == std::string::npos ) return baseFileName + suffix;
+  return baseFileName.substr(0, dot) + suffix + baseFileName.substr(dot);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputShard::Open(const G4String& baseFileName)
+{
+  Close();
+
+  // The master of a sequential run writes as thread 0
+  auto threadID = std::max(0, G4Threading::G4GetThreadId());
+  auto fileName = ShardFileName(baseFileName, threadID);
+
+  fFile = std::fopen(fileName.c_str(), "wb");
+  if ( ! fFile ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open output shard " << fileName;
+    G4Exception("OutputShard::Open()", "MyCode0005", JustWarning, msg);
+    return;
+  }
+  // Buffering is done here, not by stdio
+  std::setvbuf(fFile, nullptr, _IONBF, 0);
+  fUsed = 0;
+
+  G4AutoLock lock(&shardMutex);
+  shardRegistry[baseFileName].emplace_back(threadID, fileName);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputShard::Close()
+{
+  if ( ! fFile ) return;
+
+  Flush();
+  std::fclose(fFile);
+  fFile = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputShard::Flush()
+{
+  if ( fFile && fUsed > 0 ) {
+    std::fwrite(fBuffer.data(), 1, fUsed, fFile);
+  }
+  fUsed = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<G4String> OutputShard::TakeShards(const G4String& baseFileName)
+{
+  // Take the shards of this file out of the registry, ordered by thread
+  std::vector<std::pair<G4int, G4String>> shards;
+  {
+    G4AutoLock lock(&shardMutex);
+    shards.swap(shardRegistry[baseFileName]);
+  }
+  std::sort(shards.begin(), shards.end());
+
+  std::vector<G4String> fileNames;
+  for ( const auto& shard : shards ) {
+    fileNames.push_back(shard.second);
+  }
+  return fileNames;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputShard::MergeTextShards(const G4String& baseFileName,
+                                  const G4String& header)
+{
+  auto shards = TakeShards(baseFileName);
+  if ( ! MergeTextFiles(shards, baseFileName, header) ) return;
+
+  // Remove the merged shards
+  for ( const auto& shard : shards ) {
+    std::remove(shard.c_str());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool OutputShard::MergeTextFiles(const std::vector<G4String>& fileNames,
+                                   const G4String& outFileName,
+                                   const G4String& header)
+{
+  std::ofstream outFile(outFileName, std::ios::trunc | std::ios::binary);
+  if ( ! outFile.is_open() ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open " << outFileName << " for merging";
+    G4Exception("OutputShard::MergeTextFiles()", "MyCode0006",
+      JustWarning, msg);
+    return false;
+  }
+  outFile << header;
+
+  // One read cursor per file, positioned on its next record
+  struct Cursor {
+    std::ifstream in;
+    std::string record;
+    G4long eventID = 0;
+  };
+  auto next = [](Cursor& cursor) {
+    while ( std::getline(cursor.in, cursor.record) ) {
+      if ( cursor.record.empty()
+           || ! std::isdigit(static_cast<unsigned char>(cursor.record[0])) ) {
+        continue;
+      }
+      cursor.eventID = std::strtol(cursor.record.c_str(), nullptr, 10);
+      return true;
+    }
+    return false;
+  };
+
+  // k-way merge on (event ID, file index)
+  using Entry = std::pair<G4long, std::size_t>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+  std::vector<std::unique_ptr<Cursor>> cursors;
+  for ( const auto& fileName : fileNames ) {
+    auto cursor = std::make_unique<Cursor>();
+    cursor->in.open(fileName, std::ios::binary);
+    if ( next(*cursor) ) queue.emplace(cursor->eventID, cursors.size());
+    cursors.push_back(std::move(cursor));
+  }
+
+  while ( ! queue.empty() ) {
+    auto index = queue.top().second;
+    queue.pop();
+
+    // Copy all records of this event, they are contiguous in the file
+    auto& cursor = *cursors[index];
+    auto eventID = cursor.eventID;
+    G4bool more = false;
+    do {
+      outFile.write(cursor.record.data(), cursor.record.size());
+      outFile.put('\n');
+      more = next(cursor);
+    } while ( more && cursor.eventID == eventID );
+
+    if ( more ) queue.emplace(cursor.eventID, index);
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
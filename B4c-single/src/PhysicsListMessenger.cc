@@ -43,7 +43,7 @@
 
 PhysicsListMessenger::PhysicsListMessenger(PhysicsList* pPhys)
 :G4UImessenger(),fPhysicsList(pPhys),
- fPhysDir(0), fListCmd(0)
+ fPhysDir(0), fListCmd(0), fDnaRegionCmd(0), fTableCacheCmd(0)
 {
   fPhysDir = new G4UIdirectory("/microyz/phys/");
   fPhysDir->SetGuidance("physics list commands");
@@ -53,12 +53,31 @@ PhysicsListMessenger::PhysicsListMessenger(PhysicsList* pPhys)
   fListCmd->SetParameterName("PList",false);
   fListCmd->AvailableForStates(G4State_PreInit);
   fListCmd->SetToBeBroadcasted(false);        
+
+  fDnaRegionCmd = new G4UIcmdWithAString("/microyz/phys/dnaRegion",this);  
+  fDnaRegionCmd->SetGuidance("Use Geant4-DNA models inside the Nanodosimetry region");
+  fDnaRegionCmd->SetGuidance("around the sensitive detectors (/microyz/det/regionMargin),");
+  fDnaRegionCmd->SetGuidance("on top of a condensed-history list, e.g. emStd4_hadCustom.");
+  fDnaRegionCmd->SetParameterName("option",false);
+  fDnaRegionCmd->SetCandidates("none DNA_Opt0 DNA_Opt2 DNA_Opt4 DNA_Opt6 DNA_Opt7");
+  fDnaRegionCmd->AvailableForStates(G4State_PreInit);
+  fDnaRegionCmd->SetToBeBroadcasted(false);        
+
+  fTableCacheCmd = new G4UIcmdWithAString("/microyz/phys/tableCache",this);  
+  fTableCacheCmd->SetGuidance("Directory in which the physics tables of the first run are");
+  fTableCacheCmd->SetGuidance("stored, keyed by physics list, cuts and materials, and from");
+  fTableCacheCmd->SetGuidance("which later jobs retrieve them; none disables the cache.");
+  fTableCacheCmd->SetParameterName("directory",false);
+  fTableCacheCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fTableCacheCmd->SetToBeBroadcasted(false);        
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 PhysicsListMessenger::~PhysicsListMessenger()
 {
+  delete fTableCacheCmd;
+  delete fDnaRegionCmd;
   delete fListCmd;
   delete fPhysDir;    
 }
@@ -69,6 +88,12 @@ void PhysicsListMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
 {       
   if( command == fListCmd )
    { fPhysicsList->AddPhysicsList(newValue);}
+
+  if( command == fDnaRegionCmd )
+   { fPhysicsList->SetDnaRegion(newValue);}
+
+  if( command == fTableCacheCmd )
+   { fPhysicsList->SetTableCache(newValue);}
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
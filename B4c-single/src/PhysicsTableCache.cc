@@ -0,0 +1,276 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhysicsTableCache.cc
+/// \brief Implementation of the B4::PhysicsTableCache class
+
+#include "PhysicsTableCache.hh"
+
+#include "G4EmParameters.hh"
+#include "G4Element.hh"
+#include "G4Material.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4StateManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+#include "G4VUserPhysicsList.hh"
+#include "G4Version.hh"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+
+namespace
+{
+  // 64-bit FNV-1a, stable across platforms and runs
+  std::uint64_t Hash(const std::string& text)
+  {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for ( unsigned char c : text ) {
+      hash ^= c;
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  // Written after the tables, its presence marks a complete directory
+  const char* kKeyFile = "key.txt";
+}
+
+namespace B4
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsTableCache::PhysicsTableCache(G4VUserPhysicsList* physicsList)
+ : fPhysicsList(physicsList),
+   fStart(Clock::now())
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsTableCache::SetDirectory(const G4String& directory)
+{
+  fDirectory = ( directory == "none" ) ? G4String() : directory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhysicsTableCache::Notify(G4ApplicationState requestedState)
+{
+  // The current state is still the one being left
+  auto currentState = G4StateManager::GetStateManager()->GetCurrentState();
+
+  if ( currentState == G4State_PreInit && requestedState == G4State_Init ) {
+    fInitStart = Clock::now();
+  }
+  else if ( currentState == G4State_Idle && requestedState == G4State_Init
+            && fInitialised && ! fTablesStarted ) {
+    // Initialisation of the first run, the physics tables are built next
+    fTablesStarted = true;
+    fTablesStart = Clock::now();
+    Retrieve();
+  }
+  else if ( currentState == G4State_Init && requestedState == G4State_Idle ) {
+    if ( ! fInitialised ) {
+      fInitialised = true;
+      fInitEnd = Clock::now();
+    }
+    else if ( fTablesStarted && ! fTablesDone ) {
+      fTablesDone = true;
+      fTablesEnd = Clock::now();
+      Store();
+      Report();
+    }
+  }
+
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String PhysicsTableCache::ComputeKey() const
+{
+  std::ostringstream key;
+  key.precision(10);
+
+  key << "version " << G4Version << "\n"
+      << "physics " << fConfiguration << "\n"
+      << "defaultCut " << fPhysicsList->GetDefaultCutValue() / mm << " mm\n";
+
+  auto cutsTable = G4ProductionCutsTable::GetProductionCutsTable();
+  key << "energyRange " << cutsTable->GetLowEdgeEnergy() / eV << " "
+      << cutsTable->GetHighEdgeEnergy() / eV << " eV\n";
+
+  for ( auto region : *G4RegionStore::GetInstance() ) {
+    key << "region " << region->GetName();
+    auto cuts = region->GetProductionCuts();
+    if ( cuts != nullptr ) {
+      for ( G4int i = 0; i < NumberOfG4CutIndex; ++i ) {
+        key << " " << cuts->GetProductionCut(i) / mm;
+      }
+      key << " mm";
+    }
+    key << "\n";
+  }
+
+  for ( auto material : *G4Material::GetMaterialTable() ) {
+    key << "material " << material->GetName() << " "
+        << material->GetDensity() / (g/cm3) << " g/cm3";
+    auto elements = material->GetElementVector();
+    auto fractions = material->GetFractionVector();
+    for ( std::size_t i = 0; i < material->GetNumberOfElements(); ++i ) {
+      key << " " << (*elements)[i]->GetName() << " " << fractions[i];
+    }
+    key << "\n";
+  }
+
+  G4EmParameters::Instance()->StreamInfo(key);
+
+  return key.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsTableCache::Retrieve()
+{
+  if ( fDirectory.empty() ) return;
+
+  fKey = ComputeKey();
+  char name[17];
+  std::snprintf(name, sizeof(name), "%016llx",
+                static_cast<unsigned long long>(Hash(fKey)));
+  fTableDirectory = (std::filesystem::path(fDirectory) / name).string();
+
+  // Only a complete directory with the same key, not a hash collision
+  std::ifstream keyFile(std::filesystem::path(fTableDirectory) / kKeyFile);
+  if ( ! keyFile ) return;
+  std::string storedKey((std::istreambuf_iterator<char>(keyFile)),
+                        std::istreambuf_iterator<char>());
+  if ( storedKey != fKey ) {
+    G4ExceptionDescription msg;
+    msg << "Physics tables in " << fTableDirectory
+        << " were stored with another configuration, they are rebuilt.";
+    G4Exception("PhysicsTableCache::Retrieve()",
+      "MyCode0016", JustWarning, msg);
+    return;
+  }
+
+  fPhysicsList->SetPhysicsTableRetrieved(fTableDirectory);
+  fRetrieved = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsTableCache::Store()
+{
+  if ( fRetrieved ) {
+    // Later runs build their tables again if the cuts change
+    fPhysicsList->ResetPhysicsTableRetrieved();
+    return;
+  }
+  if ( fTableDirectory.empty() ) return;
+
+  auto start = Clock::now();
+
+  // Jobs sharing the cache directory may store the same key concurrently:
+  // each writes into its own temporary directory, which is renamed into
+  // place only when complete. The rename fails if another job was first,
+  // its tables are then kept and the temporary directory is removed.
+  char suffix[24];
+  std::snprintf(suffix, sizeof(suffix), ".tmp%08x",
+                static_cast<unsigned int>(std::random_device()()));
+  G4String temporaryDirectory = fTableDirectory + suffix;
+
+  std::error_code error;
+  std::filesystem::create_directories(temporaryDirectory, error);
+  G4bool written =
+    ! error && fPhysicsList->StorePhysicsTable(temporaryDirectory);
+  if ( written ) {
+    std::ofstream keyFile(std::filesystem::path(temporaryDirectory) / kKeyFile);
+    keyFile << fKey;
+    keyFile.close();
+    written = keyFile.good();
+  }
+  if ( written ) {
+    std::filesystem::rename(temporaryDirectory, fTableDirectory, error);
+    fStored = ! error;
+  }
+  if ( ! fStored ) {
+    std::filesystem::remove_all(temporaryDirectory, error);
+  }
+  if ( ! written ) {
+    G4ExceptionDescription msg;
+    msg << "Physics tables could not be stored in " << fTableDirectory << ".";
+    G4Exception("PhysicsTableCache::Store()",
+      "MyCode0016", JustWarning, msg);
+    return;
+  }
+
+  fStoreTime = std::chrono::duration<G4double>(Clock::now() - start).count();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsTableCache::Report() const
+{
+  auto seconds = [](Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<G4double>(to - from).count() * s;
+  };
+
+  G4cout << G4endl
+         << "--------------------Startup times--------------------" << G4endl
+         << " Application setup : "
+         << G4BestUnit(seconds(fStart, fInitStart), "Time") << G4endl
+         << " /run/initialize   : "
+         << G4BestUnit(seconds(fInitStart, fInitEnd), "Time")
+         << " (geometry and processes)" << G4endl
+         << " Physics tables    : "
+         << G4BestUnit(seconds(fTablesStart, fTablesEnd) - fStoreTime * s, "Time");
+  if ( fRetrieved ) {
+    G4cout << " (retrieved from " << fTableDirectory << ")";
+  }
+  else if ( fStored ) {
+    G4cout << " (built, stored in " << fTableDirectory << " in "
+           << G4BestUnit(fStoreTime * s, "Time") << ")";
+  }
+  else {
+    G4cout << " (built)";
+  }
+  G4cout << G4endl
+         << "-----------------------------------------------------" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
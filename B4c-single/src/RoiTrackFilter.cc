@@ -0,0 +1,206 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file RoiTrackFilter.cc
+/// \brief Implementation of the B4::RoiTrackFilter class
+
+#include "RoiTrackFilter.hh"
+
+#include "G4Electron.hh"
+#include "G4EmCalculator.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  // Energy grid of the electron range table
+  const G4double kEmin = 10 * CLHEP::eV;
+  const G4double kEmax = 10 * CLHEP::GeV;
+  const G4int    kNofBinsPerDecade = 20;
+}
+
+namespace B4
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RoiTrackFilter::Initialise()
+{
+  fInitialised = false;
+  if ( ! fEnabled ) return;
+
+  // Region of interest: the root volume of the Nanodosimetry region
+  auto region = G4RegionStore::GetInstance()->GetRegion("Nanodosimetry", false);
+  if ( region == nullptr || region->GetNumberOfRootVolumes() == 0 ) {
+    G4Exception("RoiTrackFilter::Initialise()",
+      "MyCode0010", JustWarning,
+      "No Nanodosimetry region, tracks are not killed.");
+    return;
+  }
+  auto rootLV = *(region->GetRootLogicalVolumeIterator());
+
+  const G4VPhysicalVolume* rootPV = nullptr;
+  for ( auto pv : *G4PhysicalVolumeStore::GetInstance() ) {
+    if ( pv->GetLogicalVolume() == rootLV ) {
+      rootPV = pv;
+      break;
+    }
+  }
+  if ( rootPV == nullptr ) {
+    G4Exception("RoiTrackFilter::Initialise()",
+      "MyCode0010", JustWarning,
+      "Nanodosimetry region is not placed, tracks are not killed.");
+    return;
+  }
+
+  // The root volume is placed without rotation in the world
+  G4ThreeVector pMin, pMax;
+  rootLV->GetSolid()->BoundingLimits(pMin, pMax);
+  fCenter = rootPV->GetTranslation() + 0.5 * (pMin + pMax);
+  fHalfSize = 0.5 * (pMax - pMin);
+  fMaterial = rootLV->GetMaterial();
+  fElectron = G4Electron::Definition();
+
+  // Electron CSDA range, trapezoidal integration of 1/(dE/dx)
+  const G4int nofBins
+    = G4int(std::lround(kNofBinsPerDecade * std::log10(kEmax / kEmin)));
+  fLogEmin = std::log(kEmin);
+  fInvLogStep = nofBins / std::log(kEmax / kEmin);
+  fEnergies.resize(nofBins + 1);
+  fRanges.resize(nofBins + 1);
+
+  G4EmCalculator calculator;
+  std::vector<G4double> dedx(nofBins + 1);
+  for ( G4int i = 0; i <= nofBins; ++i ) {
+    fEnergies[i] = std::exp(fLogEmin + i / fInvLogStep);
+    dedx[i] = calculator.ComputeTotalDEDX(fEnergies[i], fElectron, fMaterial);
+  }
+
+  auto first = std::find_if(dedx.begin(), dedx.end(),
+                            [](G4double value) { return value > 0.; });
+  if ( first == dedx.end() ) {
+    G4Exception("RoiTrackFilter::Initialise()",
+      "MyCode0010", JustWarning,
+      "No continuous energy loss of electrons, tracks are not killed.");
+    return;
+  }
+
+  // Below the lowest energy of the models the stopping power of that energy
+  // is used, which overestimates the range. Above the highest energy of the
+  // models the range is infinite.
+  const G4double infinity = std::numeric_limits<G4double>::infinity();
+  std::size_t iFirst = first - dedx.begin();
+  for ( std::size_t i = 0; i <= iFirst; ++i ) {
+    fRanges[i] = fEnergies[i] / *first;
+  }
+  for ( std::size_t i = iFirst + 1; i < dedx.size(); ++i ) {
+    if ( dedx[i] > 0. && fRanges[i - 1] < infinity ) {
+      fRanges[i] = fRanges[i - 1]
+        + 0.5 * (1. / dedx[i] + 1. / dedx[i - 1]) * (fEnergies[i] - fEnergies[i - 1]);
+    }
+    else {
+      fRanges[i] = infinity;
+    }
+  }
+
+  fInitialised = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double RoiTrackFilter::GetElectronRange(G4double energy) const
+{
+  if ( energy <= fEnergies.front() ) {
+    return fRanges.front() * energy / fEnergies.front();
+  }
+  if ( energy >= fEnergies.back() ) {
+    return std::numeric_limits<G4double>::infinity();
+  }
+
+  G4double x = (std::log(energy) - fLogEmin) * fInvLogStep;
+  auto i = std::min(std::size_t(x), fRanges.size() - 2);
+  G4double f = x - i;
+  return (1. - f) * fRanges[i] + f * fRanges[i + 1];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RoiTrackFilter::CanReachRoi(const G4Track* track) const
+{
+  // Vector from the closest point of the box to the track
+  G4ThreeVector offset = track->GetPosition() - fCenter;
+  G4ThreeVector away;
+  for ( G4int i = 0; i < 3; ++i ) {
+    G4double outside = std::max(std::abs(offset[i]) - fHalfSize[i], 0.);
+    away[i] = std::copysign(outside, offset[i]);
+  }
+  G4double distance = away.mag();
+  if ( distance == 0. ) return true;
+
+  auto particle = track->GetDefinition();
+  G4double energy = track->GetKineticEnergy();
+
+  // Electrons, in whatever direction, have to be within range
+  if ( particle == fElectron ) {
+    return fRangeSafety * GetElectronRange(energy) >= distance;
+  }
+
+  // Heavy charged particles moving away from the box can only reach it
+  // with their delta electrons
+  G4double mass = particle->GetPDGMass();
+  if ( particle->GetPDGCharge() == 0. || mass < 100 * MeV ) return true;
+  if ( track->GetMomentumDirection().dot(away) <= 0. ) return true;
+
+  G4double ratio = electron_mass_c2 / mass;
+  G4double tau = energy / mass;
+  G4double tmax = 2. * electron_mass_c2 * tau * (tau + 2.)
+                / (1. + 2. * (tau + 1.) * ratio + ratio * ratio);
+  return fRangeSafety * GetElectronRange(tmax) >= distance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double RoiTrackFilter::GetResidualRange(const G4Track* track) const
+{
+  if ( track->GetDefinition() != fElectron ) return 0.;
+  return GetElectronRange(track->GetKineticEnergy());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
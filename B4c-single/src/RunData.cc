@@ -0,0 +1,87 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file RunData.cc
+/// \brief Implementation of the B4::RunData class
+
+#include "RunData.hh"
+
+#include "G4AccumulableManager.hh"
+
+namespace B4
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RunData::RunData(SharedRunData* sharedRunData)
+ : fSharedRunData(sharedRunData)
+{
+  // Register accumulables to the accumulable manager of this thread
+  auto accumulableManager = G4AccumulableManager::Instance();
+  accumulableManager->RegisterAccumulable(fNofStepsProcessed);
+  accumulableManager->RegisterAccumulable(fNofStepsNoDeposit);
+  accumulableManager->RegisterAccumulable(fNofStepsClassified);
+  accumulableManager->RegisterAccumulable(fNofStepsRecorded);
+  accumulableManager->RegisterAccumulable(fNofTracksKilledStacked);
+  accumulableManager->RegisterAccumulable(fNofTracksKilledInFlight);
+  accumulableManager->RegisterAccumulable(fResidualRangeKilled);
+  accumulableManager->RegisterAccumulable(fNofStepsTracked);
+  accumulableManager->RegisterAccumulable(fTrackLengthTracked);
+  accumulableManager->RegisterAccumulable(&fClusterSizes);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunData::AddKilledTracks(G4long stacked, G4long inFlight,
+                              G4double residualRange)
+{
+  fNofTracksKilledStacked += stacked;
+  fNofTracksKilledInFlight += inFlight;
+  fResidualRangeKilled += residualRange;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunData::AddTrackedStep(G4double length)
+{
+  fNofStepsTracked += 1;
+  fTrackLengthTracked += length;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunData::AddStepFilterCounts(G4long processed, G4long noDeposit,
+                                  G4long classified, G4long recorded)
+{
+  fNofStepsProcessed += processed;
+  fNofStepsNoDeposit += noDeposit;
+  fNofStepsClassified += classified;
+  fNofStepsRecorded += recorded;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
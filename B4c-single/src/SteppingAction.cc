@@ -0,0 +1,62 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SteppingAction.cc
+/// \brief Implementation of the B4c::SteppingAction class
+
+#include "SteppingAction.hh"
+#include "RunData.hh"
+
+#include "G4RunManager.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+
+namespace B4c
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SteppingAction::UserSteppingAction(const G4Step* step)
+{
+  const auto& filter = fRunData->GetRoiTrackFilter();
+  if ( ! filter.IsEnabled() ) return;
+
+  // Steps tracked with the filter on, for the estimate of the saved steps
+  fRunData->AddTrackedStep(step->GetStepLength());
+
+  // The track is at the post-step point
+  auto track = step->GetTrack();
+  if ( track->GetTrackStatus() != fAlive ) return;
+
+  if ( ! filter.CanReachRoi(track) ) {
+    track->SetTrackStatus(fStopAndKill);
+    fRunData->AddKilledTracks(0, 1, filter.GetResidualRange(track));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}